@@ -230,6 +230,9 @@ enum settings_tags_t {
 	SET_MIN_WEBSOCKET_ANNOUNCE_INTERVAL, // int
 	SET_WEBTORRENT_CONNECTION_TIMEOUT, // int
 	SET_MAX_WEBTORRENT_OFFERS, // int
+	SET_DH_KEY_POOL_SIZE, // int
+	SET_AVAILABILITY_SAMPLE_SIZE, // int
+	SET_HYDRATED_QUEUED_LIMIT, // int
 };
 
 #endif // LIBTORRENT_SETTINGS_H
@@ -235,6 +235,9 @@ int settings_key(int const tag)
 		case SET_MIN_WEBSOCKET_ANNOUNCE_INTERVAL: return sp::min_websocket_announce_interval;
 		case SET_WEBTORRENT_CONNECTION_TIMEOUT: return sp::webtorrent_connection_timeout;
 		case SET_MAX_WEBTORRENT_OFFERS: return sp::max_webtorrent_offers;
+		case SET_DH_KEY_POOL_SIZE: return sp::dh_key_pool_size;
+		case SET_AVAILABILITY_SAMPLE_SIZE: return sp::availability_sample_size;
+		case SET_HYDRATED_QUEUED_LIMIT: return sp::hydrated_queued_limit;
 		default:
 			// ignore unknown tags
 			return -1;
@@ -677,6 +677,7 @@ class add_torrent_params(metaclass=_BoostBaseClass):
     piece_priorities: list[int]
     renamed_files: dict[int, str]
     resume_data: list[str]
+    resume_delta: bool
     root_certificate: str
     save_path: str
     seeding_time: int
@@ -2063,14 +2064,17 @@ class metadata_received_alert(torrent_alert): ...
 class metric_type_t(int):
     counter: int
     gauge: int
+    histogram: int
 
     names: Final[dict[str, int]] = {
         "counter": metric_type_t.counter,  # noqa: F821
         "gauge": metric_type_t.gauge,  # noqa: F821
+        "histogram": metric_type_t.histogram,  # noqa: F821
     }
     values: Final[dict[int, int]] = {
         0: metric_type_t.counter,  # noqa: F821
         1: metric_type_t.gauge,  # noqa: F821
+        2: metric_type_t.histogram,  # noqa: F821
     }
 
 class mmap_write_mode_t(int):
@@ -2792,6 +2796,7 @@ class save_resume_flags_t(metaclass=_BoostBaseClass):
     __instance_size__: int
     flush_disk_cache: int
     only_if_modified: int
+    save_delta: int
     save_info_dict: int
 
 class save_state_flags_t(metaclass=_BoostBaseClass):
@@ -2975,6 +2980,11 @@ class session(metaclass=_BoostBaseClass):
         async_add_torrent( (session)arg1, (add_torrent_params)arg2) -> None :
         """
 
+    def async_add_torrents(self, _torrents: list[add_torrent_params]) -> None:
+        """
+        async_add_torrents( (session)arg1, (list)arg2) -> None :
+        """
+
     def create_peer_class(self, _name: str) -> int:
         """
         create_peer_class( (session)arg1, (str)arg2) -> object :
@@ -3192,6 +3202,11 @@ class session(metaclass=_BoostBaseClass):
         post_session_stats( (session)arg1) -> None :
         """
 
+    def post_status_deltas(self, fields: int = 4294967295) -> None:
+        """
+        post_status_deltas( (session)arg1 [, (object)fields=4294967295]) -> None :
+        """
+
     def post_torrent_updates(self, flags: int = 4294967295) -> None:
         """
         post_torrent_updates( (session)arg1 [, (object)flags=4294967295]) -> None :
@@ -3608,6 +3623,9 @@ class settings_pack(TypedDict):
     min_websocket_announce_interval: NotRequired[int]
     webtorrent_connection_timeout: NotRequired[int]
     max_webtorrent_offers: NotRequired[int]
+    dh_key_pool_size: NotRequired[int]
+    availability_sample_size: NotRequired[int]
+    hydrated_queued_limit: NotRequired[int]
     allow_multiple_connections_per_ip: NotRequired[bool]
     ignore_limits_on_local_network: NotRequired[bool]
     send_redundant_have: NotRequired[bool]
@@ -4023,6 +4041,23 @@ class stats_metric(metaclass=_BoostBaseClass):
     @property
     def value_index(self) -> int: ...
 
+class status_delta_alert(alert):
+    @property
+    def deltas(self) -> list[torrent_status_delta]: ...
+
+class status_field(metaclass=_BoostBaseClass):
+    __instance_size__: int
+    all: int
+    error: int
+    flags: int
+    peers: int
+    progress: int
+    queue_position: int
+    rates: int
+    state: int
+    swarm: int
+    transfer: int
+
 class status_flags_t(metaclass=_BoostBaseClass):
     __instance_size__: int
     query_accurate_download_counters: int
@@ -4244,6 +4279,7 @@ class torrent_handle(metaclass=_BoostBaseClass):
     query_pieces: int
     query_renamed_files: int
     query_verified_pieces: int
+    save_delta: int
     save_info_dict: int
     def add_http_seed(self, _url: str) -> None:
         """
@@ -5352,6 +5388,47 @@ class torrent_status(metaclass=_BoostBaseClass):
     @property
     def verified_pieces(self) -> list[bool]: ...
 
+class torrent_status_delta(metaclass=_BoostBaseClass):
+    __instance_size__: int
+    @property
+    def all_time_download(self) -> int: ...
+    @property
+    def all_time_upload(self) -> int: ...
+    @property
+    def changed(self) -> int: ...
+    @property
+    def download_payload_rate(self) -> int: ...
+    @property
+    def flags(self) -> int: ...
+    @property
+    def has_error(self) -> bool: ...
+    @property
+    def info_hashes(self) -> info_hash_t: ...
+    @property
+    def num_complete(self) -> int: ...
+    @property
+    def num_incomplete(self) -> int: ...
+    @property
+    def num_peers(self) -> int: ...
+    @property
+    def num_seeds(self) -> int: ...
+    @property
+    def progress_ppm(self) -> int: ...
+    @property
+    def queue_position(self) -> int: ...
+    @property
+    def state(self) -> torrent_status.states: ...
+    @property
+    def total(self) -> int: ...
+    @property
+    def total_done(self) -> int: ...
+    @property
+    def total_wanted(self) -> int: ...
+    @property
+    def total_wanted_done(self) -> int: ...
+    @property
+    def upload_payload_rate(self) -> int: ...
+
 class tracker_announce_alert(tracker_alert):
     @property
     def event(self) -> event_t: ...
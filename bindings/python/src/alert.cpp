@@ -53,6 +53,13 @@ list get_status_from_update_alert(state_update_alert const& alert)
 	return result;
 }
 
+list get_deltas_from_status_delta_alert(status_delta_alert const& alert)
+{
+	list result;
+	for (auto const& d : alert.deltas) result.append(d);
+	return result;
+}
+
 list dht_stats_active_requests(dht_stats_alert const& a)
 {
 	list result;
@@ -250,6 +257,7 @@ namespace boost {
 	POLY(oversized_file_alert)
 	POLY(torrent_conflict_alert)
 	POLY(ip_ban_alert)
+	POLY(status_delta_alert)
 
 #if TORRENT_ABI_VERSION == 1
 	POLY(anonymous_mode_alert)
@@ -776,6 +784,9 @@ void bind_alert()
 	class_<state_update_alert, bases<alert>, noncopyable>("state_update_alert", no_init)
 		.add_property("status", &get_status_from_update_alert);
 
+	class_<status_delta_alert, bases<alert>, noncopyable>("status_delta_alert", no_init)
+		.add_property("deltas", &get_deltas_from_status_delta_alert);
+
 	class_<i2p_alert, bases<alert>, noncopyable>("i2p_alert", no_init)
 		.add_property("error", &i2p_alert::error);
 
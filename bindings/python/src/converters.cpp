@@ -429,6 +429,7 @@ void bind_converters()
 		from_bitfield_flag<lt::bandwidth_state_flags_t>>();
 	to_python_converter<lt::file_open_mode_t, from_bitfield_flag<lt::file_open_mode_t>>();
 	to_python_converter<lt::status_flags_t, from_bitfield_flag<lt::status_flags_t>>();
+	to_python_converter<lt::status_field_t, from_bitfield_flag<lt::status_field_t>>();
 	to_python_converter<lt::alert_category_t, from_bitfield_flag<lt::alert_category_t>>();
 	to_python_converter<lt::resume_data_flags_t, from_bitfield_flag<lt::resume_data_flags_t>>();
 	to_python_converter<lt::add_piece_flags_t, from_bitfield_flag<lt::add_piece_flags_t>>();
@@ -541,6 +542,7 @@ void bind_converters()
 	to_bitfield_flag<lt::bandwidth_state_flags_t>();
 	to_bitfield_flag<lt::file_open_mode_t>();
 	to_bitfield_flag<lt::status_flags_t>();
+	to_bitfield_flag<lt::status_field_t>();
 	to_bitfield_flag<lt::alert_category_t>();
 	to_bitfield_flag<lt::resume_data_flags_t>();
 	to_bitfield_flag<lt::add_piece_flags_t>();
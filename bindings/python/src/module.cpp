@@ -20,6 +20,7 @@ void bind_torrent_info();
 void bind_unicode_string_conversion();
 void bind_torrent_handle();
 void bind_torrent_status();
+void bind_torrent_status_delta();
 void bind_session_settings();
 void bind_version();
 void bind_alert();
@@ -50,6 +51,7 @@ BOOST_PYTHON_MODULE(libtorrent)
 	bind_session();
 	bind_torrent_info();
 	bind_torrent_status();
+	bind_torrent_status_delta();
 	bind_session_settings();
 	bind_version();
 	bind_alert();
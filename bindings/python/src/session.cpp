@@ -496,6 +496,28 @@ namespace {
 		s.async_add_torrent(std::move(p));
 	}
 
+	void wrap_async_add_torrents(lt::session& s, list torrents)
+	{
+		std::vector<add_torrent_params> params;
+		int const n = int(boost::python::len(torrents));
+		params.reserve(std::size_t(n));
+		for (int i = 0; i < n; ++i)
+		{
+			add_torrent_params const& p = extract<add_torrent_params const&>(torrents[i]);
+			if (p.save_path.empty())
+			{
+				PyErr_SetString(PyExc_ValueError, "save_path must be set in add_torrent_params");
+				throw_error_already_set();
+			}
+			params.push_back(p);
+			if (p.ti) params.back().ti = std::make_shared<torrent_info>(*p.ti);
+		}
+
+		allow_threading_guard guard;
+
+		s.async_add_torrents(std::move(params));
+	}
+
 #if TORRENT_ABI_VERSION == 1
 	void start_natpmp(lt::session& s)
 	{
@@ -1052,6 +1074,7 @@ void bind_session()
 		.add_property("merkle_tree", PROP(&add_torrent_params::merkle_tree))
 #endif
 		.add_property("renamed_files", PROP(&add_torrent_params::renamed_files))
+		.def_readwrite("resume_delta", &add_torrent_params::resume_delta)
 
 #if TORRENT_ABI_VERSION == 1
 		.def_readwrite("url", &add_torrent_params::url)
@@ -1231,6 +1254,11 @@ void bind_session()
 					allow_threads(&lt::session::post_torrent_updates),
 					arg("flags") = 0xffffffff
 				)
+				.def(
+					"post_status_deltas",
+					allow_threads(&lt::session::post_status_deltas),
+					arg("fields") = 0xffffffff
+				)
 				.def("post_dht_stats", allow_threads(&lt::session::post_dht_stats))
 				.def("post_session_stats", allow_threads(&lt::session::post_session_stats))
 				.def("is_listening", allow_threads(&lt::session::is_listening))
@@ -1262,6 +1290,7 @@ void bind_session()
 				.def("add_torrent", &add_torrent)
 				.def("async_add_torrent", &async_add_torrent)
 				.def("async_add_torrent", &wrap_async_add_torrent)
+				.def("async_add_torrents", &wrap_async_add_torrents)
 				.def("add_torrent", &wrap_add_torrent)
 #ifndef BOOST_NO_EXCEPTIONS
 #if TORRENT_ABI_VERSION == 1
@@ -1460,7 +1489,8 @@ void bind_session()
 
 	enum_<metric_type_t>("metric_type_t")
 		.value("counter", metric_type_t::counter)
-		.value("gauge", metric_type_t::gauge);
+		.value("gauge", metric_type_t::gauge)
+		.value("histogram", metric_type_t::histogram);
 
 	def("session_stats_metrics", session_stats_metrics);
 	def("find_metric_idx", find_metric_idx_wrap);
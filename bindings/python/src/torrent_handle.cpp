@@ -703,6 +703,7 @@ void bind_torrent_handle()
 		s.attr("graceful_pause") = torrent_handle::graceful_pause;
 		s.attr("flush_disk_cache") = torrent_handle::flush_disk_cache;
 		s.attr("save_info_dict") = torrent_handle::save_info_dict;
+		s.attr("save_delta") = torrent_handle::save_delta;
 		s.attr("only_if_modified") = torrent_handle::only_if_modified;
 		s.attr("alert_when_available") = torrent_handle::alert_when_available;
 		s.attr("query_distributed_copies") = torrent_handle::query_distributed_copies;
@@ -753,6 +754,7 @@ void bind_torrent_handle()
 		scope s = class_<dummy4>("save_resume_flags_t");
 		s.attr("flush_disk_cache") = torrent_handle::flush_disk_cache;
 		s.attr("save_info_dict") = torrent_handle::save_info_dict;
+		s.attr("save_delta") = torrent_handle::save_delta;
 		s.attr("only_if_modified") = torrent_handle::only_if_modified;
 	}
 
@@ -18,6 +18,10 @@ std::shared_ptr<const torrent_info> get_torrent_file(torrent_status const& st)
 	return st.torrent_file.lock();
 }
 
+namespace {
+struct dummy_status_field {};
+}
+
 void bind_torrent_status()
 {
 	scope status =
@@ -161,3 +165,43 @@ void bind_torrent_status()
 		.value("checking_resume_data", torrent_status::checking_resume_data)
 		.export_values();
 }
+
+void bind_torrent_status_delta()
+{
+	class_<torrent_status_delta>("torrent_status_delta")
+		.def_readonly("info_hashes", &torrent_status_delta::info_hashes)
+		.add_property("changed", make_getter(&torrent_status_delta::changed, by_value()))
+		.def_readonly("state", &torrent_status_delta::state)
+		.add_property("flags", make_getter(&torrent_status_delta::flags, by_value()))
+		.def_readonly("total_done", &torrent_status_delta::total_done)
+		.def_readonly("total_wanted_done", &torrent_status_delta::total_wanted_done)
+		.def_readonly("total_wanted", &torrent_status_delta::total_wanted)
+		.def_readonly("total", &torrent_status_delta::total)
+		.def_readonly("all_time_upload", &torrent_status_delta::all_time_upload)
+		.def_readonly("all_time_download", &torrent_status_delta::all_time_download)
+		.def_readonly("progress_ppm", &torrent_status_delta::progress_ppm)
+		.def_readonly("download_payload_rate", &torrent_status_delta::download_payload_rate)
+		.def_readonly("upload_payload_rate", &torrent_status_delta::upload_payload_rate)
+		.def_readonly("num_peers", &torrent_status_delta::num_peers)
+		.def_readonly("num_seeds", &torrent_status_delta::num_seeds)
+		.def_readonly("num_complete", &torrent_status_delta::num_complete)
+		.def_readonly("num_incomplete", &torrent_status_delta::num_incomplete)
+		.add_property(
+			"queue_position", make_getter(&torrent_status_delta::queue_position, by_value())
+		)
+		.def_readonly("has_error", &torrent_status_delta::has_error);
+
+	{
+		scope s = class_<dummy_status_field>("status_field");
+		s.attr("state") = status_field::state;
+		s.attr("flags") = status_field::flags;
+		s.attr("progress") = status_field::progress;
+		s.attr("rates") = status_field::rates;
+		s.attr("transfer") = status_field::transfer;
+		s.attr("peers") = status_field::peers;
+		s.attr("swarm") = status_field::swarm;
+		s.attr("queue_position") = status_field::queue_position;
+		s.attr("error") = status_field::error;
+		s.attr("all") = status_field::all;
+	}
+}
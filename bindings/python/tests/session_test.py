@@ -763,6 +763,7 @@ class EnumsTest(unittest.TestCase):
     def test_metric_type_t(self) -> None:
         self.assertIsInstance(lt.metric_type_t.counter, int)
         self.assertIsInstance(lt.metric_type_t.gauge, int)
+        self.assertIsInstance(lt.metric_type_t.histogram, int)
 
     def test_session_static_vars(self) -> None:
         self.assertIsInstance(lt.session.tcp, int)
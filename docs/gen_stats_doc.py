@@ -126,6 +126,14 @@ for line in f:
         names.append(args[0].strip() + '.' + args[1].strip())
         types.append(counter_types[args[1]])
 
+    if 'HISTOGRAM(' in line:
+        args = line.split('(')[1].split(')')[0].split(',')
+
+        # one metric per bucket
+        for i in range(32):
+            names.append('%s.%s_%d' % (args[0].strip(), args[1].strip(), i))
+            types.append('histogram')
+
 if len(names) > 0:
     render_section(names, description, types)
 
@@ -19,7 +19,8 @@ int main()
 	for (auto const& c : m)
 	{
 		std::printf("%s: %s (%d)\n"
-			, c.type == metric_type_t::counter ? "CNTR" : "GAUG"
+			, c.type == metric_type_t::counter ? "CNTR"
+				: c.type == metric_type_t::histogram ? "HIST" : "GAUG"
 			, c.name, c.value_index);
 	}
 	return 0;
@@ -352,6 +352,16 @@ TORRENT_VERSION_NAMESPACE_3
 		// non-empty it implies that all hashes in merkle_trees are verified.
 		aux::vector<bitfield, file_index_t> verified_leaf_hashes;
 
+		// set if this is resume data saved with torrent_handle::save_delta,
+		// holding only the changes since the previous save. ``have_pieces``
+		// then only has bits set for pieces completed since that save, empty
+		// ``merkle_trees`` mean the trees are unchanged and empty
+		// ``piece_priorities`` and ``file_priorities`` mean the priorities
+		// are unchanged. A delta can't be used to add a torrent by itself,
+		// it must first be folded into the resume data it follows with
+		// apply_resume_delta().
+		bool resume_delta = false;
+
 		// this is a map of file indices in the torrent and new filenames to be
 		// applied before the torrent is added.
 		aux::noexcept_movable<std::map<file_index_t, std::string>> renamed_files;
@@ -0,0 +1,142 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#ifndef TORRENT_ALERT_EXPORT_HPP_INCLUDED
+#define TORRENT_ALERT_EXPORT_HPP_INCLUDED
+
+#include <cstdint>
+
+#include "libtorrent/config.hpp"
+#include "libtorrent/fwd.hpp"
+#include "libtorrent/span.hpp"
+#include "libtorrent/alert.hpp"
+#include "libtorrent/aux_/export.hpp"
+
+namespace libtorrent {
+
+	// The alert export format is a compact, binary encoding of alerts, meant
+	// to be consumed by another process (e.g. via a shared memory ring), as
+	// a cheaper and lossless alternative to alert::message().
+	//
+	// Each alert is encoded as a record, starting with a fixed header. All
+	// integers are big-endian.
+	//
+	// .. code::
+	//
+	// 	offset  size  field
+	// 	0       4     size of the record in bytes, including the header
+	// 	4       2     alert type (alert::type())
+	// 	6       1     format version (alert_export_version)
+	// 	7       1     reserved, always 0
+	// 	8       4     alert category (alert::category())
+	// 	12      8     alert::timestamp(), in nanoseconds since the epoch of
+	// 	              the (monotonic) clock
+	//
+	// The header is followed by the fields of the alert, each encoded as a
+	// 1 byte field ID (alert_field), a 2 byte length and the value. Integer
+	// values are 4 bytes, strings are not null terminated. Consumers must
+	// skip fields they don't know about, and tolerate fields they expect
+	// being absent. The meaning of a field ID never changes.
+	constexpr int alert_export_version = 1;
+	constexpr int alert_export_header_size = 20;
+
+	// the IDs of fields in exported alert records
+	enum class alert_field : std::uint8_t
+	{
+		// the v1 and v2 info-hashes of the torrent, 20 and 32 bytes
+		info_hash_v1 = 1,
+		info_hash_v2 = 2,
+
+		// the IP and port of the peer, 4 or 16 bytes of address followed by
+		// 2 bytes of port
+		endpoint = 3,
+
+		// the 32 byte i2p destination of the peer
+		i2p_destination = 4,
+
+		// the 20 byte peer-id of the peer
+		peer_id = 5,
+
+		// the local IP and port, encoded like ``endpoint``
+		local_endpoint = 6,
+
+		// the tracker URL, string
+		tracker_url = 7,
+
+		// integers
+		piece_index = 8,
+		block_index = 9,
+		file_index = 10,
+
+		// an error_code. The 4 byte error value, followed by the name of
+		// the error category
+		error = 11,
+
+		// integers, the values of the operation_t, torrent_status::state_t,
+		// close_reason_t, socket_type_t, performance_warning_t,
+		// peer_log_alert::event_t and peer_log_alert::direction_t enums
+		operation = 12,
+		state = 13,
+		prev_state = 14,
+		close_reason = 15,
+		socket_type = 16,
+		warning_code = 17,
+		event_type = 18,
+		direction = 19,
+
+		// integers
+		num_peers = 20,
+		times_in_row = 21,
+
+		// a log message, tracker failure reason or warning, string
+		message = 22,
+
+		// the file an error is associated with, string
+		filename = 23,
+	};
+
+	// encodes ``a`` into ``buf``. Returns the number of bytes written, or 0
+	// if it doesn't fit in ``buf``. Besides the header, the fields of the
+	// torrent_alert, peer_alert and tracker_alert base classes are included,
+	// as well as the fields specific to the most common alert types.
+	TORRENT_EXPORT int export_alert(alert const& a, span<char> buf);
+
+	// encodes as many of ``alerts`` as fit into ``buf``, in order (typically
+	// the ones returned by session_handle::pop_alerts()). ``buf`` is advanced
+	// past the records written to it. Returns the number of alerts that were
+	// written. No memory is allocated.
+	TORRENT_EXPORT int export_alerts(span<alert* const> alerts, span<char>& buf);
+
+	// a record in the alert export format, as parsed by
+	// read_exported_alert(). It refers to the buffer it was parsed from.
+	struct TORRENT_EXPORT exported_alert
+	{
+		int type = 0;
+		alert_category_t category{};
+		std::int64_t timestamp = 0;
+
+		// the encoded fields of the record
+		span<char const> fields;
+
+		// returns the value of the field ``f``, or an empty span if the
+		// record doesn't have it
+		span<char const> field(alert_field f) const;
+
+		// returns the value of the integer field ``f``, or ``def`` if the
+		// record doesn't have it
+		int int_field(alert_field f, int def = -1) const;
+	};
+
+	// parses the record at the start of ``buf`` into ``out`` and advances
+	// ``buf`` past it. Returns false if ``buf`` doesn't start with a complete
+	// record.
+	TORRENT_EXPORT bool read_exported_alert(span<char const>& buf, exported_alert& out);
+}
+
+#endif
@@ -77,7 +77,7 @@ namespace libtorrent {
 	constexpr int user_alert_id = 10000;
 
 	// this constant represents "max_alert_index" + 1
-	constexpr int num_alert_types = 108;
+	constexpr int num_alert_types = 109;
 
 	// internal
 	constexpr int abi_alert_count = 128;
@@ -3300,6 +3300,27 @@ TORRENT_VERSION_NAMESPACE_4_END
 		aux::noexcept_movable<address> banned_address;
 	};
 
+	// This alert is only posted when requested by the user, by calling
+	// session_handle::post_status_deltas(). It's a compact alternative to
+	// state_update_alert, holding only the requested fields that changed, for
+	// the torrents that changed since they were last reported. Its category is
+	// ``alert_category::status``, but it's not subject to filtering, since it's
+	// only manually posted anyway.
+	struct TORRENT_EXPORT status_delta_alert final : alert
+	{
+		// internal
+		TORRENT_UNEXPORT status_delta_alert(aux::stack_allocator& alloc
+			, std::vector<torrent_status_delta> d);
+		TORRENT_DEFINE_ALERT_PRIO(status_delta_alert, 108, alert_priority::high)
+
+		static constexpr alert_category_t static_category = alert_category::status;
+		std::string message() const override;
+
+		// one record per torrent with changes to report. The changed fields
+		// of each record are indicated by its ``changed`` member.
+		std::vector<torrent_status_delta> deltas;
+	};
+
 	// internal
 	TORRENT_EXTRA_EXPORT char const* performance_warning_str(performance_alert::performance_warning_t i);
 
@@ -64,6 +64,7 @@ namespace aux {
 
 			T& alert = queue.emplace_back<T>(
 				m_allocations[m_generation & 1], std::forward<Args>(args)...);
+			m_num_queued.store(queue.size(), std::memory_order_release);
 
 			maybe_notify(&alert);
 		}
@@ -111,8 +112,22 @@ namespace aux {
 		// this mutex protects everything. Since it's held while executing user
 		// callbacks (the notify function and extension on_alert()) it must be
 		// recursive to support recursively post new alerts.
+		// The client thread only holds it for as long as it takes to swap the
+		// queues, never while visiting or destructing alerts.
 		mutable std::recursive_mutex m_mutex;
 		std::condition_variable_any m_condition;
+
+		// serializes calls to get_all(). It's what gives the calling thread
+		// exclusive access to the queue and allocator that are not currently
+		// posted to, which is why they can be reclaimed without holding
+		// m_mutex
+		std::mutex m_pop_mutex;
+
+		// the number of alerts in m_alerts[m_generation & 1]. This is
+		// updated under m_mutex, but can be read without it, to let
+		// pending(), wait_for_alert() and get_all() return early without
+		// contending with threads posting alerts
+		std::atomic<int> m_num_queued{0};
 		std::atomic<alert_category_t> m_alert_mask;
 		int m_queue_size_limit;
 
@@ -17,6 +17,7 @@ see LICENSE file.
 #include "libtorrent/error_code.hpp"
 
 #include "libtorrent/aux_/debug.hpp" // for TORRENT_ASSERT
+#include "libtorrent/aux_/handler_trace.hpp"
 
 #include <type_traits>
 #include <memory> // for shared_ptr
@@ -116,11 +117,28 @@ namespace libtorrent::aux {
 	enum HandlerName
 	{
 		// when adding a handler here, be sure to update handler_names in
-		// debug.hpp as well
+		// debug.hpp and handler_trace_name() as well
 		write_handler, read_handler, udp_handler, tick_handler, abort_handler,
 		defer_handler, utp_handler, submit_handler
 	};
 
+	// the name handlers of this kind are recorded as in handler traces
+	constexpr char const* handler_trace_name(HandlerName const name)
+	{
+		switch (name)
+		{
+			case write_handler: return "write_handler";
+			case read_handler: return "read_handler";
+			case udp_handler: return "udp_handler";
+			case tick_handler: return "tick_handler";
+			case abort_handler: return "abort_handler";
+			case defer_handler: return "defer_handler";
+			case utp_handler: return "utp_handler";
+			case submit_handler: return "submit_handler";
+		}
+		return "handler";
+	}
+
 	// this is meant to provide the actual storage for the handler allocator.
 	// There's only a single slot, so the allocator is only supposed to be used
 	// for handlers where there's only a single outstanding operation at a time,
@@ -241,6 +259,7 @@ namespace libtorrent::aux {
 		template <class... A>
 		void operator()(A&&... a)
 		{
+			TORRENT_TRACE_SCOPE(handler_trace_name(Name));
 #ifdef BOOST_NO_EXCEPTIONS
 			handler(std::forward<A>(a)...);
 #else
@@ -304,6 +323,7 @@ namespace libtorrent::aux {
 		template <class... A>
 		void operator()(A&&... a)
 		{
+			TORRENT_TRACE_SCOPE(handler_trace_name(storage_type::name));
 #ifdef BOOST_NO_EXCEPTIONS
 			(ptr_.get()->*Handler)(std::forward<A>(a)...);
 #else
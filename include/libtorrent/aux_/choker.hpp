@@ -13,6 +13,9 @@ see LICENSE file.
 
 #include "libtorrent/config.hpp"
 #include "libtorrent/time.hpp" // for time_duration
+#include "libtorrent/span.hpp"
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace libtorrent::aux {
@@ -20,6 +23,50 @@ namespace libtorrent::aux {
 	struct session_settings;
 	struct peer_connection;
 
+	// the unchoke ranking of a peer. The keys are read from the
+	// peer_connection (and its torrent) once per unchoke round, to not have to
+	// go through pointers for every comparison when ranking the peers
+	struct TORRENT_EXTRA_EXPORT unchoke_candidate
+	{
+		peer_connection* peer = nullptr;
+
+		// the upload priority of the peer
+		int priority = 0;
+
+		// the number of bytes the peer sent us in the last round
+		std::int64_t downloaded = 0;
+
+		// set for unchoked peers that have received their quota from the
+		// round-robin seed choker, and should give up their slot
+		bool quota_complete = false;
+
+		// set if the peer has outstanding requests for pieces that are in
+		// memory. Only used in the suggest_read_cache suggest mode
+		bool cached_requests = false;
+
+		// the seed choking algorithm's ranking of the peer. Higher is better
+		std::int64_t score = 0;
+
+		// the last time this peer was unchoked
+		time_point last_unchoke{};
+
+		// returns true if this peer should be preferred to be unchoked over
+		// rhs
+		bool operator<(unchoke_candidate const& rhs) const;
+	};
+
+	// moves the best ``slots`` candidates to the front, in no particular
+	// order. This is linear in the number of candidates
+	TORRENT_EXTRA_EXPORT void select_unchoke_candidates(span<unchoke_candidate> candidates
+		, int slots);
+
+	// returns the number of unchoke slots the rate based choker allows.
+	// ``rates`` holds, for each peer, the number of bytes uploaded to it in
+	// the last round weighted by its priority, and its upload rate in bytes
+	// per second. It is reordered by this call
+	TORRENT_EXTRA_EXPORT int rate_based_unchoke_slots(span<std::pair<std::int64_t, int>> rates
+		, int rate_threshold);
+
 	// sorts the vector of peers in-place. When returning, the top unchoke slots
 	// elements are the peers we should unchoke. This is similar to a partial
 	// sort. Only the unchoke slots first elements are sorted.
@@ -0,0 +1,75 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#ifndef TORRENT_DH_KEY_POOL_HPP_INCLUDED
+#define TORRENT_DH_KEY_POOL_HPP_INCLUDED
+
+#include "libtorrent/config.hpp"
+
+#if !defined TORRENT_DISABLE_ENCRYPTION
+
+#include "libtorrent/aux_/export.hpp"
+#include "libtorrent/aux_/pe_crypto.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libtorrent::aux {
+
+	// generating the local key pair for an encrypted handshake is a 768 bit
+	// modular exponentiation, the most expensive part of accepting or
+	// establishing an encrypted peer connection. This pool keeps a number of
+	// key pairs precomputed by a background thread, so the network thread
+	// only has to pick one up. When the pool is empty (or disabled, with a
+	// size of 0) keys are generated on the calling thread, just like before.
+	struct TORRENT_EXTRA_EXPORT dh_key_pool
+	{
+		dh_key_pool();
+		~dh_key_pool();
+		dh_key_pool(dh_key_pool const&) = delete;
+		dh_key_pool& operator=(dh_key_pool const&) = delete;
+
+		// the number of key pairs to keep precomputed. The background thread
+		// is started the first time this is set to a value > 0
+		void set_size(int size);
+
+		// returns a fresh key pair. Every key pair is handed out at most once
+		std::unique_ptr<dh_key_exchange> take();
+
+		// stops and joins the background thread. Any precomputed keys are
+		// discarded and take() falls back to generating keys inline
+		void abort();
+
+		// the number of key pairs currently ready to be taken
+		int num_ready() const;
+
+	private:
+
+		void thread_fun();
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_cond;
+
+		// precomputed key pairs, ready to be handed out
+		std::vector<std::unique_ptr<dh_key_exchange>> m_keys;
+
+		// the target number of keys in m_keys
+		int m_size = 0;
+		bool m_abort = false;
+
+		std::thread m_thread;
+	};
+}
+
+#endif // TORRENT_DISABLE_ENCRYPTION
+
+#endif
@@ -298,14 +298,14 @@ namespace job {
 		// the type of job this is
 		job_action_t get_type() const { return job_action_t(action.index()); }
 
-#if TORRENT_DISK_LATENCY_STATS
 		// the time this job was added to the disk job queue, stamped on the
-		// network thread. At completion (also on the network thread) the
-		// elapsed time is bucketed into the disk_read_latency* histogram, so
-		// the measured interval includes both the disk-thread queue and the
-		// completion queue. Only present in disk-latency-stats builds.
+		// network thread. When the job starts executing, the time it spent in
+		// the queue is recorded in the disk_job_queue_time_hist histogram. In
+		// disk-latency-stats builds, at completion (also on the network
+		// thread) the elapsed time is bucketed into the disk_read_latency*
+		// histogram, so the measured interval includes both the disk-thread
+		// queue and the completion queue.
 		time_point start_time{};
-#endif
 
 #if TORRENT_USE_ASSERTS
 		bool in_use = false;
@@ -12,9 +12,15 @@ see LICENSE file.
 #define TORRENT_FFS_HPP_INCLUDE
 
 #include <cstdint>
+#include "libtorrent/config.hpp"
+#include "libtorrent/assert.hpp"
 #include "libtorrent/aux_/export.hpp"
 #include "libtorrent/span.hpp"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace libtorrent {
 namespace aux {
 
@@ -43,6 +49,22 @@ namespace aux {
 
 	// returns the index of the most significant set bit.
 	TORRENT_EXTRA_EXPORT int log2p1(std::uint32_t v);
+
+	// returns the number of leading zero bits in a single word, in host byte
+	// order. ``v`` must not be 0
+	inline int leading_zeros(std::uint32_t const v)
+	{
+		TORRENT_ASSERT(v != 0);
+#if TORRENT_HAS_BUILTIN_CLZ
+		return __builtin_clz(v);
+#elif defined _MSC_VER
+		unsigned long pos;
+		_BitScanReverse(&pos, v);
+		return 31 - int(pos);
+#else
+		return 31 - log2p1(v);
+#endif
+	}
 }}
 
 #endif // TORRENT_FFS_HPP_INCLUDE
@@ -99,6 +99,9 @@ namespace libtorrent::aux {
 
 		std::vector<open_file_state> get_status(storage_index_t st) const;
 
+		// returns the files currently open for the storage ``st``
+		std::vector<std::pair<file_index_t, FileHandle>> open_files(storage_index_t st) const;
+
 		void close_oldest();
 
 	private:
@@ -0,0 +1,52 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#ifndef TORRENT_AUX_HANDLER_TRACE_HPP_INCLUDED
+#define TORRENT_AUX_HANDLER_TRACE_HPP_INCLUDED
+
+#include "libtorrent/config.hpp"
+#include "libtorrent/time.hpp"
+#include "libtorrent/aux_/export.hpp"
+
+namespace libtorrent::aux {
+
+	// the number of events held by the trace ring buffer of each thread
+	constexpr int trace_ring_size = 0x4000;
+
+	// records an event into the calling thread's trace ring buffer. ``name``
+	// must be a string literal (or otherwise outlive the trace).
+	TORRENT_EXTRA_EXPORT void record_trace_event(char const* name
+		, time_point start, time_point end);
+
+	// records an event spanning the lifetime of this object
+	struct trace_scope
+	{
+		explicit trace_scope(char const* name)
+			: m_name(name)
+			, m_start(clock_type::now())
+		{}
+		~trace_scope() { record_trace_event(m_name, m_start, clock_type::now()); }
+		trace_scope(trace_scope const&) = delete;
+		trace_scope& operator=(trace_scope const&) = delete;
+
+	private:
+		char const* m_name;
+		time_point m_start;
+	};
+}
+
+// traces the remainder of the enclosing scope, in handler-trace builds
+#if TORRENT_USE_HANDLER_TRACE
+#define TORRENT_TRACE_SCOPE(name) \
+	::libtorrent::aux::trace_scope const trace_scope_(name)
+#else
+#define TORRENT_TRACE_SCOPE(name) do {} while (false)
+#endif
+
+#endif
@@ -19,6 +19,8 @@ see LICENSE file.
 #include "libtorrent/aux_/open_mode.hpp"
 #include "libtorrent/aux_/file.hpp" // for file_handle
 
+#include <vector>
+
 #if TORRENT_HAVE_MAP_VIEW_OF_FILE
 
 #include "libtorrent/aux_/windows.hpp"
@@ -98,6 +100,11 @@ namespace aux {
 		// flushed to disk
 		void page_out(span<byte const> range);
 
+		// fills in ``pages`` with one entry per page of the mapping, non-zero
+		// if the page is resident in memory. Returns the page size, or 0 if
+		// this can't be determined, in which case ``pages`` is left empty
+		int resident_pages(std::vector<std::uint8_t>& pages) const;
+
 	private:
 
 		void close();
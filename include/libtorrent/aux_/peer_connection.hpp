@@ -111,6 +111,11 @@ namespace libtorrent::aux {
 
 		piece_block block;
 
+		// the time the request for this block was sent to the peer (i.e. when
+		// it left the send buffer). Used to measure the round-trip time of
+		// the request
+		time_point request_time{};
+
 		static constexpr std::uint32_t not_in_buffer = 0x1fffffff;
 
 		// the number of bytes into the send buffer this request is. Every time
@@ -359,6 +364,13 @@ namespace libtorrent::aux {
 		bool ignore_stats() const { return m_ignore_stats; }
 		void ignore_stats(bool b) { m_ignore_stats = b; }
 
+		// how this peer's pieces are accounted for in the torrent's piece
+		// availability. This is decided the first time the peer reports any
+		// pieces. See settings_pack::availability_sample_size
+		enum class availability_t : std::uint8_t { undecided, counted, uncounted };
+		availability_t availability_state() const { return m_availability_state; }
+		void availability_state(availability_t const s) { m_availability_state = s; }
+
 		std::uint32_t peer_rank() const;
 
 		void fast_reconnect(bool r);
@@ -586,6 +598,10 @@ namespace libtorrent::aux {
 		void send_interested();
 		void send_not_interested();
 		void send_suggest(piece_index_t piece);
+
+		// sends up to ``num`` of the torrent's suggested pieces this peer
+		// hasn't been suggested yet
+		void send_piece_suggestions(int num);
 		void send_upload_only(bool enabled);
 
 		void snub_peer();
@@ -725,8 +741,6 @@ namespace libtorrent::aux {
 		virtual void on_sent(error_code const& error
 			, std::size_t bytes_transferred) = 0;
 
-		void send_piece_suggestions(int num);
-
 		virtual
 		std::tuple<int, span<span<char const>>>
 		hit_send_barrier(span<span<char>> /* iovec */)
@@ -1176,6 +1190,8 @@ namespace libtorrent::aux {
 		// outstanding requests need to increase at the same pace to keep up.
 		bool m_slow_start:1;
 
+		availability_t m_availability_state = availability_t::undecided;
+
 #if TORRENT_USE_ASSERTS
 	public:
 		bool m_in_constructor = true;
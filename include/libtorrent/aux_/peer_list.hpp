@@ -17,6 +17,8 @@ see LICENSE file.
 #define TORRENT_POLICY_HPP_INCLUDED
 
 #include <algorithm>
+#include <cstdint>
+#include <vector>
 
 #include "libtorrent/fwd.hpp"
 #include "libtorrent/aux_/string_util.hpp" // for allocate_string_copy
@@ -135,6 +137,13 @@ namespace libtorrent::aux {
 		// our external IP changes
 		void clear_peer_prio();
 
+		// shifts all session timestamps of the peers back by ``seconds``.
+		// This is called when the epoch of the session time moves forward
+		void step_session_time(int seconds);
+
+		// makes every peer eligible to be connected to immediately
+		void clear_last_connected();
+
 #if TORRENT_USE_ASSERTS
 		bool has_connection(const peer_connection_interface* p);
 #endif
@@ -143,7 +152,10 @@ namespace libtorrent::aux {
 #endif
 
 		int num_peers() const { return int(m_peers.size()); }
-		int num_candidate_cache() const { return int(m_candidate_cache.size()); }
+		// the number of entries in the connect queue. This includes peers
+		// that have stopped being connect candidates, but have not been
+		// popped from the queue yet
+		int connect_queue_size() const { return int(m_ready.size() + m_waiting.size()); }
 
 		using peers_t = aux::deque<torrent_peer*>;
 		using iterator = peers_t::iterator;
@@ -185,16 +197,20 @@ namespace libtorrent::aux {
 
 		void recalculate_connect_candidates(torrent_state* state);
 
-		void update_connect_candidates(int delta);
+		// updates the number of connect candidates. delta is 1 if p just
+		// became a connect candidate (in which case it's added to the connect
+		// queue) and -1 if it just stopped being one
+		void update_connect_candidates(torrent_peer* p, int delta);
+
+		void queue_connect_candidate(torrent_peer* p);
+		void push_waiting(torrent_peer* p, int retry_time);
+		void push_ready(torrent_peer* p, std::uint64_t prio);
 
 		void update_peer(torrent_peer* p, peer_source_flags_t src
 			, pex_flags_t flags, tcp::endpoint const& remote);
 		bool insert_peer(torrent_peer* p, iterator iter
 			, pex_flags_t flags, torrent_state* state);
 
-		void find_connect_candidates(std::vector<torrent_peer*>& peers
-			, int session_time, torrent_state* state);
-
 		bool is_connect_candidate(torrent_peer const& p) const;
 		bool is_erase_candidate(torrent_peer const& p) const;
 		bool is_force_erase_candidate(torrent_peer const& pe) const;
@@ -205,6 +221,32 @@ namespace libtorrent::aux {
 
 		peers_t m_peers;
 
+		struct connect_entry
+		{
+			// this is set to nullptr if the peer is erased while in the queue
+			torrent_peer* peer;
+
+			// in m_ready, this is the connect priority of the peer. In
+			// m_waiting, it's the session time when it may be connected to
+			std::uint64_t key;
+
+			friend bool operator<(connect_entry const& lhs, connect_entry const& rhs)
+			{ return lhs.key < rhs.key; }
+			friend bool operator>(connect_entry const& lhs, connect_entry const& rhs)
+			{ return lhs.key > rhs.key; }
+		};
+
+		// the connect queue. Every connect candidate has exactly one entry,
+		// in one of these heaps (and has its in_connect_queue flag set).
+		// m_waiting is a min-heap of peers ordered by when they may be
+		// connected to next. Once that time has passed, they're moved to
+		// m_ready, a max-heap ordered by their connect priority. The entries
+		// are updated lazily. When a peer stops being a connect candidate or
+		// its priority or retry time changes, its entry is fixed up when it's
+		// popped.
+		std::vector<connect_entry> m_ready;
+		std::vector<connect_entry> m_waiting;
+
 		// this should be nullptr for the most part. It's set
 		// to point to a valid torrent_peer object if that
 		// object needs to be kept alive. If we ever feel
@@ -230,13 +272,6 @@ namespace libtorrent::aux {
 		// recalculate the connect candidates.
 		std::uint32_t m_finished:1;
 
-		// since the torrent_peer list can grow too large
-		// to scan all of it, start at this index
-		int m_round_robin = 0;
-
-		// a list of good connect candidates
-		std::vector<torrent_peer*> m_candidate_cache;
-
 		// The number of peers in our torrent_peer list
 		// that are connect candidates. i.e. they're
 		// not already connected and they have not
@@ -248,6 +283,11 @@ namespace libtorrent::aux {
 		// if a peer has failed this many times or more, we don't consider
 		// it a connect candidate anymore.
 		int m_max_failcount = 3;
+
+		// the number of seconds to wait before reconnecting to a peer, scaled
+		// by its failcount. This is what the retry times in m_waiting are
+		// based on
+		int m_min_reconnect_time = 60;
 	};
 
 }
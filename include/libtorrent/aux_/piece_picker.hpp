@@ -196,6 +196,9 @@ namespace libtorrent::aux {
 			// the number of blocks in the requested state
 			std::uint16_t requested:15;
 
+			// the time this piece entered the downloading state
+			time_point download_start{};
+
 #if 1
 			// set to 1 if there is an outstanding hash request for this piece
 			std::uint16_t hashing:1;
@@ -238,6 +241,14 @@ namespace libtorrent::aux {
 		void inc_refcount_all(const aux::torrent_peer* peer);
 		void dec_refcount_all(const aux::torrent_peer* peer);
 
+		// peers whose pieces are not counted towards piece availability, when
+		// availability is estimated from a sample of the peers. They don't
+		// affect the rarest-first order, but like seeds they keep every piece
+		// in the pickable list, since they may have any of them. Adding or
+		// removing one is O(1), regardless of the number of pieces
+		void inc_uncounted_peer();
+		void dec_uncounted_peer();
+
 		// we have every piece. This is used when creating a piece picker for a
 		// seed
 		void we_have_all();
@@ -412,6 +423,10 @@ namespace libtorrent::aux {
 		// this piece
 		std::vector<aux::torrent_peer*> get_downloaders(piece_index_t) const;
 
+		// returns the time the piece entered the downloading state, or a
+		// default constructed time_point if it isn't being downloaded
+		time_point download_start(piece_index_t) const;
+
 		std::vector<piece_picker::downloading_piece> get_download_queue() const;
 		int get_download_queue_size() const;
 
@@ -552,6 +567,12 @@ namespace libtorrent::aux {
 
 		bool can_pick(piece_index_t piece, typed_bitfield<piece_index_t> const& bitmask) const;
 		bool is_piece_free(piece_index_t piece, typed_bitfield<piece_index_t> const& bitmask) const;
+
+		// collects the positions in m_pieces of every pickable piece in
+		// ``bitmask``, for peers that only have a few of the pieces we want.
+		// Returns -1 if there are more than fit in ``candidates``
+		int sparse_pick_candidates(typed_bitfield<piece_index_t> const& bitmask
+			, span<prio_index_t> candidates) const;
 		index_range<piece_index_t>
 		expand_piece(piece_index_t piece, int contiguous_blocks
 			, typed_bitfield<piece_index_t> const& have
@@ -714,7 +735,8 @@ namespace libtorrent::aux {
 				// filtered pieces (prio = 0), pieces we have or pieces with
 				// availability = 0 should not be present in the piece list
 				// returning -1 indicates that they shouldn't.
-				if (filtered() || flushed() || peer_count + picker->m_seeds == 0
+				if (filtered() || flushed()
+					|| peer_count + picker->m_seeds + picker->m_uncounted_peers == 0
 					|| state() == piece_full
 					|| state() == piece_finished)
 					return -1;
@@ -836,6 +858,10 @@ namespace libtorrent::aux {
 		// the availability counters of the pieces
 		int m_seeds = 0;
 
+		// the number of peers that aren't part of the availability sample.
+		// See inc_uncounted_peer()
+		int m_uncounted_peers = 0;
+
 		// this vector contains all piece indices that are pickable
 		// sorted by priority. Pieces are in random random order
 		// among pieces with the same priority
@@ -916,6 +942,13 @@ namespace libtorrent::aux {
 		enum { max_pieces = (std::numeric_limits<int>::max)() - 1 };
 
 	};
+
+	// computes distributed copies, in the same form as
+	// piece_picker::distributed_copies(), from a vector of per-piece
+	// availability. This is used for torrents we're seeding, which don't keep
+	// a piece picker around
+	TORRENT_EXTRA_EXPORT std::pair<int, int> distributed_copies(
+		span<int const> availability);
 }
 
 #endif // TORRENT_PIECE_PICKER_HPP_INCLUDED
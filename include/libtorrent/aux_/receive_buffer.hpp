@@ -25,7 +25,11 @@ struct TORRENT_EXTRA_EXPORT receive_buffer
 {
 	friend struct crypto_receive_buffer;
 
-	// explicitly disallow assignment, to silence msvc warning
+	receive_buffer() = default;
+	~receive_buffer();
+
+	// explicitly disallow copying, to silence msvc warning
+	receive_buffer(receive_buffer const&) = delete;
 	receive_buffer& operator=(receive_buffer const&) = delete;
 
 	int packet_size() const { return m_packet_size; }
@@ -99,6 +103,11 @@ struct TORRENT_EXTRA_EXPORT receive_buffer
 
 private:
 
+	// replaces m_recv_buffer by one of (at least) ``size`` bytes, starting
+	// with the bytes in ``keep``. The old buffer is handed back to the
+	// per-thread cache, to be reused by this, or another, connection
+	void replace_buffer(int size, span<char const> keep);
+
 	// m_recv_buffer.data() (start of actual receive buffer)
 	// |
 	// |      m_recv_start (start of current packet)
@@ -26,6 +26,7 @@ see LICENSE file.
 #include "libtorrent/performance_counters.hpp" // for counters
 #include "libtorrent/aux_/allocating_handler.hpp"
 #include "libtorrent/aux_/time.hpp"
+#include "libtorrent/aux_/timer_wheel.hpp"
 #include "libtorrent/aux_/torrent_list.hpp"
 #include "libtorrent/session_params.hpp" // for disk_io_constructor_type
 
@@ -51,6 +52,7 @@ see LICENSE file.
 #include "libtorrent/assert.hpp"
 #include "libtorrent/aux_/alert_manager.hpp" // for alert_manager
 #include "libtorrent/aux_/deadline_timer.hpp"
+#include "libtorrent/aux_/dh_key_pool.hpp"
 #include "libtorrent/aux_/socket_io.hpp" // for print_address
 #include "libtorrent/address.hpp"
 #include "libtorrent/aux_/utp_socket_manager.hpp"
@@ -432,6 +434,8 @@ namespace aux {
 			void async_accept(std::shared_ptr<tcp::acceptor> const&, transport);
 			void on_accept_connection(true_tcp_socket s, error_code const&
 				, std::weak_ptr<tcp::acceptor>, transport);
+			void accept_connection(true_tcp_socket s
+				, std::shared_ptr<tcp::acceptor> const& listener, transport ssl);
 
 			void incoming_connection(socket_type);
 
@@ -544,7 +548,11 @@ namespace aux {
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
 			torrent const* find_encrypted_torrent(
-				sha1_hash const& info_hash, sha1_hash const& xor_mask) override;
+				sha1_hash const& info_hash, sha1_hash const& xor_mask
+				, protocol_version& version) override;
+
+			std::unique_ptr<dh_key_exchange> take_dh_key() override
+			{ return m_dh_keys.take(); }
 #endif
 
 			void on_lsd_announce(error_code const& e);
@@ -604,6 +612,12 @@ namespace aux {
 			// the add_torrent_params object must be moved in
 			torrent_handle add_torrent(add_torrent_params&&, error_code& ec);
 
+			// adds torrents from a batch in async_add_torrents(). Paused,
+			// auto-managed torrents have their initialization deferred
+			// and don't trigger the auto-manager individually
+			torrent_handle add_torrent_internal(add_torrent_params&&
+				, error_code& ec, bool batch);
+
 			// second return value is true if the torrent was added and false if an
 			// existing one was found.
 			std::tuple<std::shared_ptr<torrent>, info_hash_t, bool>
@@ -611,6 +625,7 @@ namespace aux {
 			std::tuple<std::shared_ptr<torrent>, info_hash_t, bool>
 			add_torrent_impl(add_torrent_params const& p, error_code& ec) = delete;
 			void async_add_torrent(std::unique_ptr<add_torrent_params> params);
+			void async_add_torrents(std::vector<add_torrent_params> params);
 
 			void remove_torrent(torrent_handle const& h, remove_flags_t options) override;
 			void remove_torrent_impl(std::shared_ptr<torrent> tptr, remove_flags_t options) override;
@@ -621,6 +636,7 @@ namespace aux {
 			void refresh_torrent_status(std::vector<torrent_status>* ret
 				, status_flags_t flags) const;
 			void post_torrent_updates(status_flags_t flags);
+			void post_status_deltas(status_field_t fields);
 			void post_session_stats();
 			void post_dht_stats();
 
@@ -866,6 +882,7 @@ namespace aux {
 			void update_auto_sequential();
 			void update_max_failcount();
 			void update_resolver_cache_timeout();
+			void update_dh_key_pool_size();
 
 			void update_ip_notifier();
 			void update_upnp();
@@ -885,6 +902,7 @@ namespace aux {
 			void update_validate_https();
 
 			void trigger_auto_manage() override;
+			void deferred_init_done() override;
 
 		private:
 
@@ -997,6 +1015,20 @@ namespace aux {
 			// ordered by their queue position
 			aux::vector<torrent*, queue_position_t> m_download_queue;
 
+			// torrents added by async_add_torrents() whose initialization has
+			// been deferred, in the order they were added. Torrents that have
+			// been removed, or initialized by other means, are skipped when
+			// they reach the front
+			std::deque<std::weak_ptr<torrent>> m_deferred_init;
+
+			// the number of deferred torrents that have been initialized and
+			// are still waiting for their resume data check to complete. At
+			// most one per disk thread is kept in flight
+			int m_deferred_checks = 0;
+
+			// set while a call to init_deferred_torrents() is posted
+			bool m_pending_deferred_init = false;
+
 			// peer connections are put here when disconnected to avoid
 			// race conditions with the disk thread. It's important that
 			// peer connections are destructed from the network thread,
@@ -1014,6 +1046,20 @@ namespace aux {
 			// peers.
 			connection_map m_connections;
 
+			// incoming connections that haven't been attached to a torrent
+			// yet, keyed by when their handshake times out (in whole seconds
+			// of the steady clock). Connections that have been attached by the
+			// time their timer fires are ignored, so this only ever visits
+			// connections that are actually due to be checked, rather than
+			// scanning m_connections every second.
+			timer_wheel<std::weak_ptr<peer_connection>> m_handshake_timeouts;
+
+#if !defined TORRENT_DISABLE_ENCRYPTION
+			// local key pairs for encrypted handshakes, precomputed on a
+			// background thread. See settings_pack::dh_key_pool_size
+			dh_key_pool m_dh_keys;
+#endif
+
 #ifdef TORRENT_SSL_PEERS
 			// this list holds incoming connections while they
 			// are performing SSL handshake. When we shut down
@@ -1140,6 +1186,7 @@ namespace aux {
 #endif
 
 			void on_tick(error_code const& e);
+			void check_handshake_timeouts(time_point now);
 
 			void try_connect_more_peers();
 			void auto_manage_checking_torrents(std::vector<torrent*>& list
@@ -1148,6 +1195,7 @@ namespace aux {
 				, int& dht_limit, int& tracker_limit
 				, int& lsd_limit, int& hard_limit, int type_limit);
 			void recalculate_auto_managed_torrents();
+			void init_deferred_torrents();
 			void recalculate_unchoke_slots();
 			void recalculate_optimistic_unchoke_slots();
 
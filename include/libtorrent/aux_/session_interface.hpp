@@ -55,6 +55,9 @@ namespace aux {
 	struct torrent_peer;
 	struct torrent_peer_allocator_interface;
 	struct external_ip;
+#if !defined TORRENT_DISABLE_ENCRYPTION
+	class dh_key_exchange;
+#endif
 }
 
 	// hidden
@@ -198,6 +201,11 @@ namespace libtorrent::aux {
 
 		virtual void trigger_auto_manage() = 0;
 
+		// called by a torrent whose initialization was deferred once the
+		// resume data check issued by torrent::init_deferred() is done (or
+		// the torrent was aborted), to let the next deferred torrent start
+		virtual void deferred_init_done() = 0;
+
 		virtual void apply_settings_pack(std::shared_ptr<settings_pack> pack) = 0;
 		virtual session_settings const& settings() const = 0;
 
@@ -266,8 +274,14 @@ namespace libtorrent::aux {
 #endif
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
+		// ``version`` is set to the protocol version of the info-hash that
+		// matched, if a torrent is found
 		virtual torrent const* find_encrypted_torrent(
-			sha1_hash const& info_hash, sha1_hash const& xor_mask) = 0;
+			sha1_hash const& info_hash, sha1_hash const& xor_mask
+			, protocol_version& version) = 0;
+
+		// returns a fresh local key pair for an encrypted handshake
+		virtual std::unique_ptr<dh_key_exchange> take_dh_key() = 0;
 #endif
 
 #ifndef TORRENT_DISABLE_DHT
@@ -17,6 +17,7 @@ see LICENSE file.
 #include "libtorrent/bitfield.hpp"
 #include "libtorrent/aux_/sliding_average.hpp"
 #include "libtorrent/aux_/vector.hpp"
+#include "libtorrent/span.hpp"
 
 namespace libtorrent::aux {
 
@@ -88,6 +89,14 @@ struct suggest_piece
 		m_priority_pieces.push_back(index);
 	}
 
+	// replaces the suggested pieces with ``pieces``, in order of increasing
+	// priority. This is used when we know which pieces are in the cache,
+	// rather than guessing based on which pieces were recently read
+	void set_pieces(span<piece_index_t const> pieces)
+	{
+		m_priority_pieces.assign(pieces.begin(), pieces.end());
+	}
+
 private:
 
 	// these are pieces that would be good candidates for suggesting
@@ -0,0 +1,167 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#ifndef TORRENT_TIMER_WHEEL_HPP_INCLUDED
+#define TORRENT_TIMER_WHEEL_HPP_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "libtorrent/assert.hpp"
+
+namespace libtorrent::aux {
+
+// a hierarchical timing wheel. Values are scheduled to expire at an absolute
+// tick (the unit is up to the user, typically seconds) and are handed back by
+// advance() once that tick has been reached. Scheduling is O(1) and advance()
+// only visits the slots whose time has come, so a wheel holding a large number
+// of timers that are far from expiring costs nothing per tick.
+//
+// There is no way to cancel a timer. Owners are expected to check whether the
+// timer is still relevant when it fires (e.g. by storing a weak_ptr) and
+// simply ignore it otherwise, rescheduling if the deadline has moved.
+template <typename T>
+struct timer_wheel
+{
+	explicit timer_wheel(std::int64_t const now = 0) : m_now(now) {}
+
+	// schedule ``v`` to be returned by advance() once the current tick
+	// reaches ``tick``. Ticks in the past (or the current tick) expire on the
+	// next call to advance() that moves time forward.
+	void schedule(T v, std::int64_t const tick)
+	{
+		insert(entry{std::move(v), std::max(tick, m_now + 1)});
+		++m_size;
+	}
+
+	// moves the current time forward to ``now``, calling ``f`` with every
+	// value whose tick is <= now, in order of expiry. ``f`` is allowed to
+	// schedule new timers.
+	template <typename Fun>
+	void advance(std::int64_t const now, Fun&& f)
+	{
+		std::vector<entry> expired;
+		while (m_now < now)
+		{
+			if (m_size == 0)
+			{
+				// nothing to expire, there's no need to step through all
+				// the slots in between
+				m_now = now;
+				break;
+			}
+
+			++m_now;
+			cascade();
+
+			auto& slot = m_slots[0][slot_index(m_now, 0)];
+			if (slot.empty()) continue;
+
+			// the callback may schedule new timers, but never into this slot
+			// (everything it schedules expires at m_now + 1 or later, and
+			// that's at most num_slots - 1 slots away at level 0)
+			expired.swap(slot);
+			for (auto& e : expired)
+			{
+				if (e.tick > m_now)
+				{
+					// this timer was clamped to the furthest representable
+					// tick when it was scheduled, it's not due yet
+					insert(std::move(e));
+					continue;
+				}
+				--m_size;
+				f(std::move(e.value));
+			}
+			expired.clear();
+			if (slot.empty()) slot.swap(expired);
+		}
+	}
+
+	// the number of timers that have not expired yet
+	int size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	// the tick last passed to advance() (or the constructor)
+	std::int64_t now() const { return m_now; }
+
+private:
+
+	struct entry
+	{
+		T value;
+		std::int64_t tick;
+	};
+
+	static constexpr int slot_bits = 6;
+	static constexpr int num_slots = 1 << slot_bits;
+	static constexpr int num_levels = 4;
+
+	// timers further into the future than this are parked in the top level
+	// and re-inserted as they cascade down
+	static constexpr std::int64_t max_delta
+		= (std::int64_t(1) << (slot_bits * num_levels)) - 1;
+
+	static int slot_index(std::int64_t const tick, int const level)
+	{
+		return int((tick >> (slot_bits * level)) & (num_slots - 1));
+	}
+
+	void insert(entry e)
+	{
+		TORRENT_ASSERT(e.tick > m_now);
+		std::int64_t const target = std::min(e.tick, m_now + max_delta);
+		std::int64_t const delta = target - m_now;
+		int level = 0;
+		while (level < num_levels - 1
+			&& delta >= (std::int64_t(1) << (slot_bits * (level + 1))))
+			++level;
+		m_slots[level][slot_index(target, level)].push_back(std::move(e));
+	}
+
+	// whenever a level wraps around, the next slot of the level above it
+	// is redistributed into the finer-grained levels below
+	void cascade()
+	{
+		for (int level = 1; level < num_levels; ++level)
+		{
+			if (slot_index(m_now, level - 1) != 0) break;
+			auto& slot = m_slots[level][slot_index(m_now, level)];
+			if (slot.empty()) continue;
+			std::vector<entry> moving;
+			moving.swap(slot);
+			for (auto& e : moving)
+			{
+				if (e.tick <= m_now)
+				{
+					// this timer is due right now. Put it in the current
+					// level 0 slot, which is the one about to be expired
+					m_slots[0][slot_index(m_now, 0)].push_back(std::move(e));
+					continue;
+				}
+				insert(std::move(e));
+			}
+		}
+	}
+
+	std::array<std::array<std::vector<entry>, num_slots>, num_levels> m_slots;
+
+	// the current time, in ticks
+	std::int64_t m_now;
+
+	// the total number of timers in all slots
+	int m_size = 0;
+};
+
+}
+
+#endif
@@ -391,8 +391,10 @@ namespace libtorrent::aux {
 
 		bool is_deleted() const { return m_deleted; }
 
-		// starts the announce timer
-		void start();
+		// starts the announce timer. If defer_init is true and the torrent is
+		// added paused and auto-managed, init() is put off until the session
+		// gets to it in its queue of deferred torrents (see init_deferred())
+		void start(bool defer_init = false);
 
 		void added()
 		{
@@ -437,6 +439,15 @@ namespace libtorrent::aux {
 		// it will initialize the storage and the piece-picker
 		void init();
 
+		// true if the torrent has metadata but was started with its
+		// initialization deferred, and hasn't been initialized yet
+		bool is_init_deferred() const { return m_deferred_init; }
+
+		// called by the session to initialize a deferred torrent. Once the
+		// resume data check this issues completes (or fails to be issued),
+		// the torrent calls session_interface::deferred_init_done()
+		void init_deferred();
+
 		void load_merkle_trees(aux::vector<std::vector<sha256_hash>, file_index_t> t
 			, aux::vector<bitfield, file_index_t> mask
 			, aux::vector<bitfield, file_index_t> verified);
@@ -456,6 +467,8 @@ namespace libtorrent::aux {
 		bool is_self_connection(peer_id const& pid) const;
 
 		void on_resume_data_checked(status_t status, storage_error const& error);
+		void deferred_check_done();
+		void hydrate();
 		void on_force_recheck(status_t status, storage_error const& error);
 		void on_piece_hashed(aux::vector<sha256_hash> block_hashes
 			, piece_index_t piece, sha1_hash const& piece_hash
@@ -553,7 +566,10 @@ namespace libtorrent::aux {
 		stat statistics() const { return m_stat; }
 		std::optional<std::int64_t> bytes_left() const;
 
-		void bytes_done(torrent_status& st, status_flags_t) const;
+		// fills in total_wanted, total_wanted_done, total_done and total of
+		// either a torrent_status or a torrent_status_delta
+		template <typename Status>
+		void bytes_done(Status& st, status_flags_t) const;
 
 		void sent_bytes(int bytes_payload, int bytes_protocol);
 		void received_bytes(int bytes_payload, int bytes_protocol);
@@ -637,6 +653,11 @@ namespace libtorrent::aux {
 		void post_piece_availability();
 		void piece_availability(aux::vector<int, piece_index_t>& avail) const;
 
+		// computes the piece availability from the bitfields of the
+		// connected peers. Seeds don't have a piece picker to keep track of
+		// it
+		void seed_piece_availability(aux::vector<int, piece_index_t>& avail) const;
+
 		void set_piece_priority(piece_index_t index, download_priority_t priority);
 		download_priority_t piece_priority(piece_index_t index) const;
 
@@ -665,6 +686,10 @@ namespace libtorrent::aux {
 		void post_status(status_flags_t flags);
 		void status(torrent_status* st, status_flags_t flags);
 
+		// fills in the ``fields`` of the status that changed since the last
+		// call. Returns false if none of them did
+		bool status_delta(torrent_status_delta* d, status_field_t fields);
+
 		// this torrent changed state, if the user is subscribing to
 		// it, add it to the m_state_updates list in session_impl
 		void state_updated();
@@ -805,6 +830,17 @@ namespace libtorrent::aux {
 		void on_rtc_stream(aux::rtc_stream_init stream_init);
 #endif
 		void remove_connection(peer_connection const* p);
+
+		// asks the disk I/O subsystem which pieces are in memory, and suggests
+		// the rarest of them to peers
+		void update_cached_pieces();
+
+		// decides whether the peer's pieces are counted in the piece picker,
+		// the first time it reports any. Returns true if they are
+		bool count_availability(peer_connection* p, bool seed);
+
+		// removes the peer's pieces from the piece picker, when it disconnects
+		void remove_availability(peer_connection* p);
 	public:
 // --------------------------------------------
 		// TRACKER MANAGEMENT
@@ -957,12 +993,12 @@ namespace libtorrent::aux {
 		}
 
 		// when we get a have message, this is called for that piece
-		void peer_has(piece_index_t index, peer_connection const* peer);
+		void peer_has(piece_index_t index, peer_connection* peer);
 
 		// when we get a bitfield message, this is called for that piece
-		void peer_has(typed_bitfield<piece_index_t> const& bits, peer_connection const* peer);
+		void peer_has(typed_bitfield<piece_index_t> const& bits, peer_connection* peer);
 
-		void peer_has_all(peer_connection const* peer);
+		void peer_has_all(peer_connection* peer);
 
 		void peer_lost(piece_index_t index, peer_connection const* peer);
 		void peer_lost(typed_bitfield<piece_index_t> const& bits
@@ -1223,6 +1259,19 @@ namespace libtorrent::aux {
 		torrent_handle get_handle();
 
 		void write_resume_data(resume_data_flags_t const flags, add_torrent_params& ret) const;
+		void write_resume_peers(add_torrent_params& ret) const;
+
+		// strips the full resume data in ret down to what changed since the
+		// previous save (see torrent_handle::save_delta). ``changed`` is what
+		// m_need_save_resume_data was before this save
+		void make_resume_delta(add_torrent_params& ret, resume_data_flags_t changed);
+
+		// a dormant torrent is a queued torrent that has released the parts
+		// of its state that aren't needed until it's started. Its peer list
+		// is kept in m_dormant_state, as encoded resume data. It's restored
+		// when the torrent is resumed
+		void make_dormant();
+		bool is_dormant() const { return !m_dormant_state.empty(); }
 
 		void seen_complete() { m_last_seen_complete = aux::posix_time(); }
 		int time_since_complete() const { return int(aux::posix_time() - m_last_seen_complete); }
@@ -1365,6 +1414,13 @@ namespace libtorrent::aux {
 		}
 		void add_suggest_piece(piece_index_t index);
 
+		// returns true if the disk I/O subsystem reported this piece to be in
+		// memory, the last time we asked. See update_cached_pieces()
+		bool is_piece_cached(piece_index_t const index) const
+		{
+			return index < m_cached_pieces.end_index() && m_cached_pieces.get_bit(index);
+		}
+
 		client_data_t get_userdata() const { return m_userdata; }
 
 		static constexpr int no_gauge_state = 0xf;
@@ -1496,6 +1552,13 @@ namespace libtorrent::aux {
 		// us.
 		aux::suggest_piece m_suggest_pieces;
 
+		// the pieces the disk I/O subsystem last reported to be in memory.
+		// Empty if it doesn't know (or suggest mode is disabled)
+		typed_bitfield<piece_index_t> m_cached_pieces;
+
+		// the last time m_cached_pieces was updated
+		time_point32 m_last_cached_pieces_update{seconds32(0)};
+
 		aux::tracker_list m_trackers;
 
 #ifndef TORRENT_DISABLE_STREAMING
@@ -1552,6 +1615,21 @@ namespace libtorrent::aux {
 		// cycle, and not in the constructor. So we need to save it here
 		std::unique_ptr<add_torrent_params> m_add_torrent_params;
 
+		// while the torrent is dormant, this is the bencoded resume data
+		// holding the peers of its peer list (see make_dormant())
+		std::vector<char> m_dormant_state;
+
+		// the pieces we had as of the last time resume data was saved. This
+		// is what resume data deltas are relative to. It's only kept once
+		// resume data has been saved with torrent_handle::save_delta
+		typed_bitfield<piece_index_t> m_resume_delta_base;
+
+		// the values most recently reported by status_delta(). Its
+		// ``changed`` field holds the status fields that were requested. This
+		// is only allocated once the torrent has been included in a
+		// status_delta_alert
+		std::unique_ptr<torrent_status_delta> m_last_status_delta;
+
 		// if the torrent is started without metadata, it may
 		// still be given a name until the metadata is received
 		// once the metadata is received this field will no
@@ -1840,6 +1918,11 @@ namespace libtorrent::aux {
 		// m_num_seeds, but have not yet been connected
 		std::uint16_t m_num_connecting_seeds = 0;
 
+		// the number of peers whose pieces are counted in the piece picker's
+		// availability. When availability_sample_size is set, peers beyond
+		// that are added to the picker as uncounted peers
+		std::uint16_t m_num_availability_peers = 0;
+
 		// the timestamp of the last byte uploaded from this torrent specified in
 		// seconds since epoch.
 		time_point32 m_last_upload{seconds32(0)};
@@ -1898,6 +1981,14 @@ namespace libtorrent::aux {
 		// prevent us from sending it again to anyone
 		std::uint32_t m_complete_sent:1;
 
+		// set when start() deferred init(). The storage, piece picker and
+		// peer list are not constructed until init() is called
+		std::uint32_t m_deferred_init:1;
+
+		// set while the resume data check issued by init_deferred() is
+		// outstanding, to tell the session once it completes
+		std::uint32_t m_deferred_check_pending:1;
+
 #if TORRENT_USE_ASSERTS
 		// set to true when torrent is start()ed. It may only be started once
 		bool m_was_started = false;
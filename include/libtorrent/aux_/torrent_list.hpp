@@ -53,6 +53,17 @@ struct torrent_list
 
 	std::size_t size() const { return m_array.size(); }
 
+	// make room for n torrents, to avoid growing (and rehashing) the
+	// indices one torrent at a time when adding many torrents at once
+	void reserve(std::size_t const n)
+	{
+		m_array.reserve(n);
+		m_index.reserve(n);
+#if !defined TORRENT_DISABLE_ENCRYPTION
+		m_obfuscated_index.reserve(n);
+#endif
+	}
+
 	T* operator[](std::size_t const idx)
 	{
 		TORRENT_ASSERT(idx < m_array.size());
@@ -89,12 +100,7 @@ struct torrent_list
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
 				if (rollback[2 + int(v)])
-				{
-					static char const req2[4] = { 'r', 'e', 'q', '2' };
-					hasher h(req2);
-					h.update(hash);
-						m_obfuscated_index.erase(h.final());
-				}
+					m_obfuscated_index.erase(obfuscated_hash(hash));
 #endif
 			});
 		});
@@ -105,12 +111,7 @@ struct torrent_list
 				rollback[int(v)] = true;
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
-			static char const req2[4] = { 'r', 'e', 'q', '2' };
-			hasher h(req2);
-			h.update(hash);
-			// this is SHA1("req2" + info-hash), used for
-			// encrypted hand shakes
-			if (m_obfuscated_index.insert({h.final(), t.get()}).second)
+			if (m_obfuscated_index.insert({obfuscated_hash(hash), {t.get(), v}}).second)
 				rollback[2 + int(v)] = true;
 #endif
 		});
@@ -123,11 +124,25 @@ struct torrent_list
 	}
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
-	T* find_obfuscated(sha1_hash const& ih)
+	// looks up a torrent by SHA1("req2" + info-hash), as received in an
+	// encrypted handshake. If ``v`` is set, it receives the protocol version
+	// of the info-hash that matched, sparing the caller from hashing all of
+	// the torrent's info-hashes again to find out
+	T* find_obfuscated(sha1_hash const& ih, protocol_version* v = nullptr)
 	{
 		auto const i = m_obfuscated_index.find(ih);
 		if (i == m_obfuscated_index.end()) return nullptr;
-		return i->second;
+		if (v) *v = i->second.version;
+		return i->second.torrent;
+	}
+
+	// this is SHA1("req2" + info-hash), used for encrypted hand shakes
+	static sha1_hash obfuscated_hash(sha1_hash const& ih)
+	{
+		static char const req2[4] = { 'r', 'e', 'q', '2' };
+		hasher h(req2);
+		h.update(ih);
+		return h.final();
 	}
 #endif
 
@@ -154,10 +169,7 @@ struct torrent_list
 			}
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
-			static char const req2[4] = { 'r', 'e', 'q', '2' };
-			hasher h(req2);
-			h.update(hash);
-			m_obfuscated_index.erase(h.final());
+			m_obfuscated_index.erase(obfuscated_hash(hash));
 #endif
 		});
 		if (!found) return false;
@@ -213,7 +225,7 @@ struct torrent_list
 #if !defined TORRENT_DISABLE_ENCRYPTION
 		for (auto const& t : m_obfuscated_index)
 		{
-			all_obf_indexed_torrents.insert(t.second);
+			all_obf_indexed_torrents.insert(t.second.torrent);
 		}
 #endif
 
@@ -231,9 +243,16 @@ private:
 	torrent_map m_index;
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
+	struct obfuscated_entry
+	{
+		T* torrent;
+		// which of the torrent's info-hashes this entry was derived from
+		protocol_version version;
+	};
+
 	// this maps obfuscated hashes to torrents. It's only
 	// used when encryption is enabled
-	torrent_map m_obfuscated_index;
+	std::unordered_map<sha1_hash, obfuscated_entry> m_obfuscated_index;
 #endif
 };
 
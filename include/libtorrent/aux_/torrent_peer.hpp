@@ -202,6 +202,9 @@ namespace libtorrent::aux {
 		std::uint32_t web_seed:1;
 		// this peer supports protocol version 2
 		std::uint32_t protocol_v2:1;
+		// this is set while the peer has an entry in the peer_list's
+		// connect queue
+		std::uint32_t in_connect_queue:1;
 #if TORRENT_USE_ASSERTS
 		std::uint32_t in_use = true;
 #endif
@@ -553,6 +553,10 @@ see LICENSE file.
 #define TORRENT_DISK_LATENCY_STATS 0
 #endif
 
+#ifndef TORRENT_USE_HANDLER_TRACE
+#define TORRENT_USE_HANDLER_TRACE 0
+#endif
+
 #ifndef TORRENT_HAS_SYMLINK
 #define TORRENT_HAS_SYMLINK 0
 #endif
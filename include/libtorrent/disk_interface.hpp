@@ -21,6 +21,7 @@ see LICENSE file.
 #include "libtorrent/units.hpp"
 #include "libtorrent/disk_buffer_holder.hpp"
 #include "libtorrent/aux_/vector.hpp"
+#include "libtorrent/bitfield.hpp"
 #include "libtorrent/aux_/export.hpp"
 #include "libtorrent/storage_defs.hpp"
 #include "libtorrent/time.hpp"
@@ -349,6 +350,16 @@ namespace file_open_mode {
 		// in.
 		virtual std::vector<open_file_state> get_status(storage_index_t) const = 0;
 
+		// Return the pieces of the specified storage whose data is currently
+		// held in memory, i.e. reading them is not expected to touch the disk.
+		// This is used to suggest pieces to peers, when
+		// settings_pack::suggest_mode is ``suggest_read_cache``. It's called
+		// periodically from the network thread and should be cheap. The
+		// default implementation returns an empty bitfield, meaning the cache
+		// state is not known.
+		virtual typed_bitfield<piece_index_t> cached_pieces(storage_index_t) const
+		{ return {}; }
+
 		// this is called when the session is starting to shut down. The disk
 		// I/O object is expected to flush any outstanding write jobs, cancel
 		// hash jobs and initiate tearing down of any internal threads. If
@@ -24,6 +24,9 @@ TORRENT_VERSION_NAMESPACE_3_END
 // include/libtorrent/alert.hpp
 struct alert;
 
+// include/libtorrent/alert_export.hpp
+struct exported_alert;
+
 // include/libtorrent/alert_types.hpp
 struct dht_routing_bucket;
 TORRENT_VERSION_NAMESPACE_4
@@ -130,6 +133,7 @@ struct tracker_list_alert;
 struct file_priorities_alert;
 struct file_status_alert;
 struct ip_ban_alert;
+struct status_delta_alert;
 
 // include/libtorrent/announce_entry.hpp
 TORRENT_VERSION_NAMESPACE_2
@@ -239,6 +243,9 @@ struct counters;
 // include/libtorrent/piece_block.hpp
 struct piece_block;
 
+// include/libtorrent/resume_store.hpp
+struct resume_store;
+
 // include/libtorrent/session.hpp
 struct session_proxy;
 struct session;
@@ -276,6 +283,7 @@ TORRENT_VERSION_NAMESPACE_4_END
 TORRENT_VERSION_NAMESPACE_4
 struct torrent_status;
 TORRENT_VERSION_NAMESPACE_4_END
+struct torrent_status_delta;
 
 // include/libtorrent/web_seed_entry.hpp
 struct web_seed_entry;
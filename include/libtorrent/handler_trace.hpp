@@ -0,0 +1,44 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#ifndef TORRENT_HANDLER_TRACE_HPP_INCLUDED
+#define TORRENT_HANDLER_TRACE_HPP_INCLUDED
+
+#include "libtorrent/config.hpp"
+#include "libtorrent/aux_/export.hpp"
+
+#include <string>
+
+namespace libtorrent {
+
+	// Handler tracing records the start and end time of the handlers run by
+	// the network thread (socket and timer completion handlers, calls made
+	// through session_handle and torrent_handle, disk job completions) and
+	// of the major functions run on every session tick. It's meant to
+	// attribute stalls of the network thread.
+	//
+	// Tracing is only enabled when libtorrent is built with
+	// ``handler-trace=on`` (which defines ``TORRENT_USE_HANDLER_TRACE=1``).
+	// Each thread records into its own ring buffer, holding the most recent
+	// 16384 events. In builds without handler tracing, no events are
+	// recorded.
+	//
+	// returns the recorded events in the Chrome trace-event JSON format, as
+	// understood by chrome://tracing and Perfetto. Every event is a
+	// "complete" event (``"ph":"X"``), with the start time (``ts``) and the
+	// duration (``dur``) in microseconds. Threads are identified by ``tid``.
+	// ``tools/parse_handler_trace.py`` summarizes the slowest handlers in
+	// such a file.
+	TORRENT_EXPORT std::string handler_trace_json();
+
+	// discards all events recorded so far, on all threads
+	TORRENT_EXPORT void clear_handler_trace();
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include "libtorrent/add_torrent_params.hpp"
 #include "libtorrent/address.hpp"
 #include "libtorrent/alert.hpp"
+#include "libtorrent/alert_export.hpp"
 #include "libtorrent/alert_types.hpp"
 #include "libtorrent/announce_entry.hpp"
 #include "libtorrent/assert.hpp"
@@ -33,6 +34,7 @@
 #include "libtorrent/flags.hpp"
 #include "libtorrent/fwd.hpp"
 #include "libtorrent/gzip.hpp"
+#include "libtorrent/handler_trace.hpp"
 #include "libtorrent/hasher.hpp"
 #include "libtorrent/hex.hpp"
 #include "libtorrent/i2p_stream.hpp"
@@ -87,6 +89,7 @@
 #include "libtorrent/pread_disk_io.hpp"
 #include "libtorrent/random.hpp"
 #include "libtorrent/read_resume_data.hpp"
+#include "libtorrent/resume_store.hpp"
 #include "libtorrent/session.hpp"
 #include "libtorrent/session_handle.hpp"
 #include "libtorrent/session_params.hpp"
@@ -26,7 +26,9 @@ namespace libtorrent {
 	// One instance lives on the session and is incremented from the
 	// network thread; reads from other threads use the lock-free
 	// ``operator[]`` overload when ``ATOMIC_LLONG_LOCK_FREE`` is set,
-	// otherwise a single shared mutex guards the whole array.
+	// otherwise a single shared mutex guards the whole array. In the
+	// lock-free case, counters are kept in per-thread shards, which are
+	// summed when read (e.g. when a ``session_stats_alert`` is posted).
 	//
 	// A reference to this object is passed to custom disk I/O
 	// implementations (see disk_interface and the disk_io_constructor
@@ -35,6 +37,10 @@ namespace libtorrent {
 	// the session-statistics_ section.
 	struct TORRENT_EXPORT counters
 	{
+		// the number of counters making up each histogram. See
+		// add_histogram_sample().
+		static constexpr int num_histogram_buckets = 32;
+
 		// internal
 		enum stats_counter_t
 		{
@@ -348,7 +354,27 @@ namespace libtorrent {
 			disk_read_latency19,
 			disk_read_latency20,
 
-			num_stats_counters
+			// log2 histograms of latencies, in microseconds. Each histogram
+			// is made up of num_histogram_buckets consecutive counters,
+			// starting at the one named here. Bucket n counts samples in the
+			// range [2^(n-1), 2^n) microseconds, bucket 0 counts samples of 0
+			// and the last bucket also counts every sample larger than its
+			// range.
+			//
+			// the time disk jobs spend in the disk job queue and the time it
+			// takes to execute them, measured on the disk threads
+			disk_job_queue_time_hist,
+			disk_job_exec_time_hist = disk_job_queue_time_hist + num_histogram_buckets,
+
+			// the time from a block request being sent to a peer until the
+			// block is received
+			block_request_rtt_hist = disk_job_exec_time_hist + num_histogram_buckets,
+
+			// the time from the first block of a piece being requested until
+			// the piece passes the hash check
+			piece_download_time_hist = block_request_rtt_hist + num_histogram_buckets,
+
+			num_stats_counters = piece_download_time_hist + num_histogram_buckets
 		};
 
 		// == ALL FOLLOWING ARE GAUGES ==
@@ -501,11 +527,14 @@ namespace libtorrent {
 		counters& operator=(counters const&) & TORRENT_COUNTER_NOEXCEPT;
 
 		// increments the counter or gauge ``c`` (an index into the counter
-		// array) by ``value`` and returns the new value.
+		// array) by ``value`` and returns the new value. Counters (as opposed
+		// to gauges) are incremented in a shard owned by the calling thread,
+		// and the value returned for them is only the sum of the increments
+		// made to that shard. Use ``operator[]`` to read the total.
 		std::int64_t inc_stats_counter(int c, std::int64_t value = 1) TORRENT_COUNTER_NOEXCEPT;
 
 		// returns the current value of counter or gauge ``i`` (an index into
-		// the counter array).
+		// the counter array). For counters, this sums all shards.
 		std::int64_t operator[](int i) const TORRENT_COUNTER_NOEXCEPT;
 
 		// overwrites the value of counter or gauge ``c`` (an index into
@@ -515,14 +544,34 @@ namespace libtorrent {
 		void set_value(int c, std::int64_t value) TORRENT_COUNTER_NOEXCEPT;
 		void blend_stats_counter(int c, std::int64_t value, int ratio) TORRENT_COUNTER_NOEXCEPT;
 
+		// records ``value`` in the histogram starting at counter ``h`` (e.g.
+		// ``disk_job_queue_time_hist``), by incrementing the bucket it falls
+		// in.
+		void add_histogram_sample(int h, std::int64_t value) TORRENT_COUNTER_NOEXCEPT;
+
 	private:
 
 		// TODO: some space could be saved here by making gauges 32 bits
-		// TODO: restore these to regular integers. Instead have one copy
-		// of the counters per thread and collect them at convenient
-		// synchronization points
 #ifdef ATOMIC_LLONG_LOCK_FREE
+		// the number of copies of the counters (not gauges). Threads are
+		// assigned a shard each, round-robin, and increment counters there,
+		// to not have the network, disk and hashing threads write to the
+		// same cache lines
+		static constexpr int num_counter_shards = 8;
+
+		struct alignas(64) counter_shard
+		{
+			aux::array<std::atomic<std::int64_t>, num_stats_counters> counter;
+		};
+
+		// returns the sum of counter ``c`` across all shards
+		std::int64_t sum_shards(int c) const noexcept;
+
+		// gauges, and the base value of counters. The value of a counter is
+		// its base value plus its value in every shard. The base is only
+		// written by set_value()
 		aux::array<std::atomic<std::int64_t>, num_counters> m_stats_counter;
+		aux::array<counter_shard, num_counter_shards> m_shards;
 #else
 		// if the atomic type isn't lock-free, use a single lock instead, for
 		// the whole array
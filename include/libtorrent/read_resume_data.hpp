@@ -10,6 +10,8 @@ see LICENSE file.
 #ifndef TORRENT_READ_RESUME_DATA_HPP_INCLUDE
 #define TORRENT_READ_RESUME_DATA_HPP_INCLUDE
 
+#include <vector>
+
 #include "libtorrent/fwd.hpp"
 #include "libtorrent/error_code.hpp"
 #include "libtorrent/aux_/export.hpp"
@@ -62,6 +64,22 @@ namespace libtorrent {
 		, int piece_limit = 0x200000);
 	TORRENT_EXPORT add_torrent_params read_resume_data(span<char const> buffer
 		, load_torrent_limits const& cfg = {});
+
+	// parses the full resume data in ``base`` and folds each of the resume
+	// data ``deltas`` (saved with torrent_handle::save_delta) into it, in the
+	// order they were saved. If a delta fails to parse, or belongs to a
+	// different torrent, ``ec`` is set and the returned object holds the
+	// state up to the delta before it. A delta that's a full save (i.e. with
+	// resume_delta not set) replaces everything before it.
+	TORRENT_EXPORT add_torrent_params read_resume_data(span<char const> base
+		, span<std::vector<char> const> deltas, error_code& ec
+		, load_torrent_limits const& cfg = {});
+
+	// folds the resume data delta ``delta`` into ``base``, which is the
+	// result of all previous saves. After this call, ``base`` can be used
+	// to add the torrent, or have more deltas folded into it.
+	TORRENT_EXPORT void apply_resume_delta(add_torrent_params& base
+		, add_torrent_params delta);
 }
 
 #endif
@@ -0,0 +1,91 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#ifndef TORRENT_RESUME_STORE_HPP_INCLUDED
+#define TORRENT_RESUME_STORE_HPP_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libtorrent/config.hpp"
+#include "libtorrent/fwd.hpp"
+#include "libtorrent/error_code.hpp"
+#include "libtorrent/aux_/export.hpp"
+
+namespace libtorrent {
+
+namespace aux {
+	struct resume_store_impl;
+}
+
+	// resume_store keeps the resume data of all torrents in a session in a
+	// single, append-only file, as an alternative to one file per torrent.
+	// Saving a torrent's resume data appends a record to the end of the file,
+	// which makes checkpointing proportional to what changed, especially when
+	// saving deltas (see torrent_handle::save_delta).
+	//
+	// Every record is checksummed. A record that was only partially written
+	// (e.g. because of a crash) is ignored when loading, along with anything
+	// after it.
+	//
+	// The file is written by a thread owned by the resume_store, so save() and
+	// remove() don't block on disk I/O. Once the file has grown to more than
+	// twice the size of the records that are still needed (each torrent's most
+	// recent full save and the deltas saved after it), it's compacted, by
+	// writing one record per torrent to a new file and replacing the old one
+	// with it.
+	//
+	// At startup, load() reads the whole file in a single sequential pass and
+	// returns the resume data of every torrent, ready to be passed to
+	// session_handle::async_add_torrents().
+	struct TORRENT_EXPORT resume_store
+	{
+		// opens the store at ``path``. The file is not created until the
+		// first record is written.
+		explicit resume_store(std::string path);
+
+		// writes any records still queued before returning
+		~resume_store();
+
+		resume_store(resume_store const&) = delete;
+		resume_store& operator=(resume_store const&) = delete;
+
+		// reads the resume data of all torrents in the store. Deltas are
+		// folded into the full resume data they follow. Torrents are returned
+		// in the order they were first saved. A store that doesn't exist yet
+		// is empty. This should be called before saving anything to the
+		// store, as records queued before it may or may not be included.
+		std::vector<add_torrent_params> load(error_code& ec);
+
+		// queues the resume data ``atp`` (typically from a
+		// save_resume_data_alert) to be appended to the store. A full save
+		// replaces everything saved for the torrent before it, a delta is
+		// applied on top of it.
+		void save(add_torrent_params atp);
+
+		// queues the removal of all resume data of the torrent with the
+		// info-hashes ``ih``, e.g. when it's removed from the session.
+		void remove(info_hash_t const& ih);
+
+		// blocks until every record queued so far has been written and synced
+		// to disk. Returns the first error writing the store failed with, if
+		// any, and clears it.
+		error_code flush();
+
+		// compacts the file now, regardless of how much of it is stale
+		void compact();
+
+	private:
+		std::unique_ptr<aux::resume_store_impl> m_impl;
+	};
+
+}
+
+#endif
@@ -200,6 +200,19 @@ namespace aux { struct torrent; }
 		// see status_flags_t in torrent_handle.
 		void post_torrent_updates(status_flags_t flags = status_flags_t::all());
 
+		// A lighter alternative to post_torrent_updates(). Instructs the
+		// session to post a status_delta_alert with a torrent_status_delta
+		// record for every torrent whose state changed since the last call,
+		// holding only the ``fields`` (see status_field) that changed since
+		// that torrent was last reported. Torrents none of whose requested
+		// fields changed are left out. No torrent_status objects are built.
+		//
+		// Just like post_torrent_updates(), only torrents with the
+		// torrent_flags::update_subscribe flag set are included. The two
+		// functions share the set of changed torrents, so a client should use
+		// one or the other.
+		void post_status_deltas(status_field_t fields = status_field_t::all());
+
 		// This function will post a session_stats_alert object, containing a
 		// snapshot of the performance counters from the internals of libtorrent.
 		// To interpret these counters, query the session via
@@ -279,6 +292,22 @@ namespace aux { struct torrent; }
 		void async_add_torrent(add_torrent_params&& params);
 		void async_add_torrent(add_torrent_params const& params);
 
+		// adds a batch of torrents in a single call to the network thread.
+		// This is the most efficient way of adding a large number of torrents,
+		// for instance when restoring a session at startup. Each torrent
+		// results in an add_torrent_alert, just like async_add_torrent().
+		//
+		// Torrents in the batch that are added both paused and auto-managed
+		// (i.e. queued) defer constructing their storage, piece picker and
+		// peer list, and checking their resume data. The session initializes
+		// them in the background, in the order they were added, keeping at
+		// most one resume data check per disk thread (see
+		// settings_pack::aio_threads) in flight. Until then, such a torrent is
+		// in the checking_resume_data state. Resuming it initializes it right
+		// away, and save_resume_data() passes on the resume data it was added
+		// with.
+		void async_add_torrents(std::vector<add_torrent_params> params);
+
 #ifndef BOOST_NO_EXCEPTIONS
 #if TORRENT_ABI_VERSION == 1
 		// deprecated in 0.14
@@ -19,10 +19,12 @@ namespace libtorrent {
 
 	// classifies a session statistic. ``counter`` values monotonically
 	// increase (e.g. total bytes received); ``gauge`` values fluctuate up
-	// and down (e.g. number of connected peers). See ``stats_metric``.
+	// and down (e.g. number of connected peers). ``histogram`` values are
+	// monotonically increasing counts of samples falling in one bucket of a
+	// histogram (e.g. disk job latencies). See ``stats_metric``.
 	enum class metric_type_t
 	{
-		counter, gauge
+		counter, gauge, histogram
 	};
 
 	// describes one statistics metric from the session. For more information,
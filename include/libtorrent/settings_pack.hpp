@@ -1231,7 +1231,11 @@ namespace aux {
 			//
 			// * ``no_piece_suggestions`` which will not send out suggest messages.
 			// * ``suggest_read_cache`` which will send out suggest messages for
-			//   the most recent pieces that are in the read cache.
+			//   the most recent pieces that are in the read cache. If the disk
+			//   I/O subsystem can tell which pieces are resident in memory
+			//   (the mmap based one can), the rarest of those are suggested
+			//   instead, refreshed every 10 seconds, and peers requesting them
+			//   are preferred when unchoking.
 			suggest_mode,
 
 			// ``max_queued_disk_bytes`` is the maximum number of bytes, to
@@ -2179,6 +2183,39 @@ namespace aux {
 			// to 0 to disable WebTorrent offers.
 			max_webtorrent_offers,
 
+			// the number of key pairs for encrypted handshakes (see
+			// enc_policy) to keep precomputed by a background thread. Generating
+			// the local Diffie-Hellman key is the single most expensive operation
+			// when accepting or making an encrypted peer connection. Precomputing
+			// keys moves that work off of the network thread, which can be
+			// significant under a high rate of incoming connections. When the
+			// pool runs dry, keys are generated on the network thread. 0 disables
+			// the pool (and the thread).
+			dh_key_pool_size,
+
+			// the number of peers per torrent whose pieces are counted towards
+			// piece availability, used for rarest-first piece picking. Keeping
+			// exact availability costs time proportional to the number of
+			// pieces every time a peer joins or leaves, which adds up for
+			// torrents with many pieces and a lot of peer churn. Peers beyond
+			// this number still have their pieces picked from, but don't
+			// contribute to the rarest-first order, and adding or removing them
+			// is constant time. Seeds are always counted, since that's cheap.
+			// Peers are assigned to the sample as they report their pieces.
+			// Availability reported for the torrent (e.g. distributed copies)
+			// reflects the sample. 0 means all peers are counted.
+			availability_sample_size,
+
+			// the number of queued torrents (paused and auto-managed) that keep
+			// all of their state in memory. Queued torrents beyond this number,
+			// in the order the auto-manager would start them, are made
+			// dormant: their peer list is reduced to the peers that would be
+			// saved in resume data and stored in a compact encoded form, and
+			// their hash picker is released. A dormant torrent is restored
+			// when it's started. -1 means there is no limit, and no torrent is
+			// made dormant.
+			hydrated_queued_limit,
+
 			max_int_setting_internal
 		};
 
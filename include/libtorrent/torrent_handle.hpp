@@ -65,6 +65,7 @@ namespace aux {
 #endif
 
 	using status_flags_t = flags::bitfield_flag<std::uint32_t, struct status_flags_tag>;
+	using status_field_t = flags::bitfield_flag<std::uint32_t, struct status_field_tag>;
 	using add_piece_flags_t = flags::bitfield_flag<std::uint8_t, struct add_piece_flags_tag>;
 	using pause_flags_t = flags::bitfield_flag<std::uint8_t, struct pause_flags_tag>;
 	using deadline_flags_t = flags::bitfield_flag<std::uint8_t, struct deadline_flags_tag>;
@@ -709,6 +710,19 @@ namespace aux {
 		// around separately, or for torrents that were added via a magnet link.
 		static inline constexpr resume_data_flags_t save_info_dict = 1_bit;
 
+		// only save what changed since the previous call to
+		// save_resume_data(). The add_torrent_params in the
+		// save_resume_data_alert has resume_delta set, and its
+		// ``have_pieces`` only has the pieces completed since then. Merkle
+		// trees of files without any new pieces are left empty, as are piece-
+		// and file priorities unless they changed. The first save with this
+		// flag, and any save after the torrent lost pieces (e.g. from
+		// force_recheck()), is a full save, without resume_delta set. Deltas
+		// are folded back into the full resume data with
+		// apply_resume_delta(), or by passing them to read_resume_data().
+		// This flag is ignored by get_resume_data().
+		static inline constexpr resume_data_flags_t save_delta = 2_bit;
+
 		// save resume data if any counters has changed since the last time
 		// resume data was saved. This includes upload/download counters, active
 		// time counters and scrape data. A torrent that is not paused will have
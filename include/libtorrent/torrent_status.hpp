@@ -583,6 +583,82 @@ TORRENT_VERSION_NAMESPACE_4
 	};
 
 TORRENT_VERSION_NAMESPACE_4_END
+
+	// these are the fields of torrent_status_delta that can be requested by
+	// session_handle::post_status_deltas(). Each flag covers one or more
+	// members of torrent_status_delta.
+	namespace status_field {
+
+		// ``state``
+		constexpr status_field_t state = 0_bit;
+
+		// ``flags``
+		constexpr status_field_t flags = 1_bit;
+
+		// ``progress_ppm``, ``total_done``, ``total_wanted_done``,
+		// ``total_wanted`` and ``total``
+		constexpr status_field_t progress = 2_bit;
+
+		// ``download_payload_rate`` and ``upload_payload_rate``
+		constexpr status_field_t rates = 3_bit;
+
+		// ``all_time_download`` and ``all_time_upload``
+		constexpr status_field_t transfer = 4_bit;
+
+		// ``num_peers`` and ``num_seeds``
+		constexpr status_field_t peers = 5_bit;
+
+		// ``num_complete`` and ``num_incomplete``
+		constexpr status_field_t swarm = 6_bit;
+
+		// ``queue_position``
+		constexpr status_field_t queue_position = 7_bit;
+
+		// ``has_error``
+		constexpr status_field_t error = 8_bit;
+
+		// all of the above
+		constexpr status_field_t all = status_field_t::all();
+	}
+
+	// a compact record of the fields of a torrent's status that changed since
+	// it was last reported, as posted in status_delta_alert. Unlike
+	// torrent_status, it's trivially copyable and holds no strings or
+	// containers. Only the members covered by ``changed`` are valid, the others
+	// are left at their default values. The members have the same meaning as
+	// the torrent_status members of the same name.
+	struct TORRENT_EXPORT torrent_status_delta
+	{
+		// identifies the torrent this record refers to. The torrent_handle can
+		// be looked up with session_handle::find_torrent().
+		info_hash_t info_hashes;
+
+		// the status_field flags of the members that changed, and are set in
+		// this record
+		status_field_t changed{};
+
+		torrent_status::state_t state{};
+		torrent_flags_t flags{};
+		std::int64_t total_done = 0;
+		std::int64_t total_wanted_done = 0;
+		std::int64_t total_wanted = 0;
+		std::int64_t total = 0;
+		std::int64_t all_time_upload = 0;
+		std::int64_t all_time_download = 0;
+		int progress_ppm = 0;
+		int download_payload_rate = 0;
+		int upload_payload_rate = 0;
+		int num_peers = 0;
+		int num_seeds = 0;
+		int num_complete = -1;
+		int num_incomplete = -1;
+		queue_position_t queue_position{};
+
+		// true if the torrent is stopped because of an error. The error itself
+		// can be queried with torrent_handle::status().
+		bool has_error = false;
+	};
+
 } // namespace libtorrent
 
 namespace std {
@@ -3204,7 +3204,8 @@ namespace {
 			"tracker_list",
 			"file_priorities",
 			"file_status",
-			"ip_ban"}};
+			"ip_ban",
+			"status_delta"}};
 
 		TORRENT_ASSERT(alert_type >= 0);
 		TORRENT_ASSERT(alert_type < num_alert_types);
@@ -3410,4 +3411,20 @@ namespace {
 #endif
 	}
 
+	status_delta_alert::status_delta_alert(aux::stack_allocator&
+		, std::vector<torrent_status_delta> d)
+		: deltas(std::move(d))
+	{}
+
+	std::string status_delta_alert::message() const
+	{
+#ifdef TORRENT_DISABLE_ALERT_MSG
+		return {};
+#else
+		char msg[100];
+		std::snprintf(msg, sizeof(msg), "status deltas for %d torrents", int(deltas.size()));
+		return msg;
+#endif
+	}
+
 } // namespace libtorrent
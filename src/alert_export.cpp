@@ -0,0 +1,319 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "libtorrent/alert_export.hpp"
+#include "libtorrent/alert_types.hpp"
+#include "libtorrent/aux_/io_bytes.hpp"
+#include "libtorrent/aux_/socket_io.hpp"
+
+#include <algorithm> // for min
+#include <cstring> // for memcpy, strlen
+#include <chrono>
+
+namespace libtorrent {
+
+namespace {
+
+	// writes fields into a record. Once a field doesn't fit, the record is
+	// marked as failed and every subsequent write is ignored
+	struct record_writer
+	{
+		explicit record_writer(span<char> buf)
+			: m_ptr(buf.data())
+			, m_end(buf.data() + buf.size())
+		{}
+
+		bool ok() const { return m_ok; }
+		char* ptr() const { return m_ptr; }
+
+		bool reserve(std::ptrdiff_t const n)
+		{
+			if (!m_ok || m_end - m_ptr < n) m_ok = false;
+			return m_ok;
+		}
+
+		void field(alert_field const f, span<char const> v)
+		{
+			if (v.size() > 0xffff) v = v.first(0xffff);
+			if (!reserve(3 + v.size())) return;
+			aux::write_uint8(static_cast<std::uint8_t>(f), m_ptr);
+			aux::write_uint16(v.size(), m_ptr);
+			std::memcpy(m_ptr, v.data(), std::size_t(v.size()));
+			m_ptr += v.size();
+		}
+
+		void int_field(alert_field const f, int const v)
+		{
+			char buf[4];
+			char* ptr = buf;
+			aux::write_int32(v, ptr);
+			field(f, buf);
+		}
+
+		void string_field(alert_field const f, char const* str)
+		{
+			if (str == nullptr) return;
+			field(f, {str, std::ptrdiff_t(std::strlen(str))});
+		}
+
+		void endpoint_field(alert_field const f, tcp::endpoint const& ep)
+		{
+			char buf[18];
+			char* ptr = buf;
+			aux::write_endpoint(ep, ptr);
+			field(f, {buf, ptr - buf});
+		}
+
+		void error_field(error_code const& ec)
+		{
+			if (!ec) return;
+			char buf[100];
+			char* ptr = buf;
+			aux::write_int32(ec.value(), ptr);
+			char const* name = ec.category().name();
+			std::size_t const len = std::min(std::strlen(name)
+				, sizeof(buf) - std::size_t(ptr - buf));
+			std::memcpy(ptr, name, len);
+			field(alert_field::error, {buf, ptr - buf + std::ptrdiff_t(len)});
+		}
+
+	private:
+		char* m_ptr;
+		char* m_end;
+		bool m_ok = true;
+	};
+
+	template <typename T>
+	void block_fields(record_writer& w, T const* a)
+	{
+		w.int_field(alert_field::piece_index, static_cast<int>(a->piece_index));
+		w.int_field(alert_field::block_index, a->block_index);
+	}
+
+	void type_fields(record_writer& w, alert const& a)
+	{
+		switch (a.type())
+		{
+			case file_completed_alert::alert_type:
+			{
+				auto const* fa = static_cast<file_completed_alert const*>(&a);
+				w.int_field(alert_field::file_index, static_cast<int>(fa->index));
+				break;
+			}
+			case performance_alert::alert_type:
+			{
+				auto const* pa = static_cast<performance_alert const*>(&a);
+				w.int_field(alert_field::warning_code, pa->warning_code);
+				break;
+			}
+			case state_changed_alert::alert_type:
+			{
+				auto const* sa = static_cast<state_changed_alert const*>(&a);
+				w.int_field(alert_field::state, sa->state);
+				w.int_field(alert_field::prev_state, sa->prev_state);
+				break;
+			}
+			case tracker_error_alert::alert_type:
+			{
+				auto const* ta = static_cast<tracker_error_alert const*>(&a);
+				w.int_field(alert_field::times_in_row, ta->times_in_row);
+				w.error_field(ta->error);
+				w.int_field(alert_field::operation, static_cast<int>(ta->op));
+				w.string_field(alert_field::message, ta->failure_reason());
+				break;
+			}
+			case tracker_warning_alert::alert_type:
+			{
+				auto const* ta = static_cast<tracker_warning_alert const*>(&a);
+				w.string_field(alert_field::message, ta->warning_message());
+				break;
+			}
+			case tracker_reply_alert::alert_type:
+			{
+				auto const* ta = static_cast<tracker_reply_alert const*>(&a);
+				w.int_field(alert_field::num_peers, ta->num_peers);
+				break;
+			}
+			case hash_failed_alert::alert_type:
+			{
+				auto const* ha = static_cast<hash_failed_alert const*>(&a);
+				w.int_field(alert_field::piece_index, static_cast<int>(ha->piece_index));
+				break;
+			}
+			case piece_finished_alert::alert_type:
+			{
+				auto const* pa = static_cast<piece_finished_alert const*>(&a);
+				w.int_field(alert_field::piece_index, static_cast<int>(pa->piece_index));
+				break;
+			}
+			case request_dropped_alert::alert_type:
+				block_fields(w, static_cast<request_dropped_alert const*>(&a));
+				break;
+			case block_timeout_alert::alert_type:
+				block_fields(w, static_cast<block_timeout_alert const*>(&a));
+				break;
+			case block_finished_alert::alert_type:
+				block_fields(w, static_cast<block_finished_alert const*>(&a));
+				break;
+			case block_downloading_alert::alert_type:
+				block_fields(w, static_cast<block_downloading_alert const*>(&a));
+				break;
+			case peer_error_alert::alert_type:
+			{
+				auto const* pa = static_cast<peer_error_alert const*>(&a);
+				w.int_field(alert_field::operation, static_cast<int>(pa->op));
+				w.error_field(pa->error);
+				break;
+			}
+			case peer_disconnected_alert::alert_type:
+			{
+				auto const* pa = static_cast<peer_disconnected_alert const*>(&a);
+				w.int_field(alert_field::socket_type, static_cast<int>(pa->socket_type));
+				w.int_field(alert_field::operation, static_cast<int>(pa->op));
+				w.error_field(pa->error);
+				w.int_field(alert_field::close_reason, static_cast<int>(pa->reason));
+				break;
+			}
+			case file_error_alert::alert_type:
+			{
+				auto const* fa = static_cast<file_error_alert const*>(&a);
+				w.error_field(fa->error);
+				w.int_field(alert_field::operation, static_cast<int>(fa->op));
+				w.string_field(alert_field::filename, fa->filename());
+				break;
+			}
+			case torrent_error_alert::alert_type:
+			{
+				auto const* ta = static_cast<torrent_error_alert const*>(&a);
+				w.error_field(ta->error);
+				w.string_field(alert_field::filename, ta->filename());
+				break;
+			}
+			case log_alert::alert_type:
+				w.string_field(alert_field::message
+					, static_cast<log_alert const*>(&a)->log_message());
+				break;
+			case torrent_log_alert::alert_type:
+				w.string_field(alert_field::message
+					, static_cast<torrent_log_alert const*>(&a)->log_message());
+				break;
+			case peer_log_alert::alert_type:
+			{
+				auto const* pa = static_cast<peer_log_alert const*>(&a);
+				w.int_field(alert_field::event_type, pa->event_type);
+				w.int_field(alert_field::direction, pa->direction);
+				w.string_field(alert_field::message, pa->log_message());
+				break;
+			}
+			default: break;
+		}
+	}
+
+} // anonymous namespace
+
+	int export_alert(alert const& a, span<char> const buf)
+	{
+		if (buf.size() < alert_export_header_size) return 0;
+
+		char* const start = buf.data();
+		char* ptr = start;
+		// the record size is filled in once it's known
+		aux::write_uint32(0, ptr);
+		aux::write_uint16(a.type(), ptr);
+		aux::write_uint8(alert_export_version, ptr);
+		aux::write_uint8(0, ptr);
+		aux::write_uint32(static_cast<std::uint32_t>(a.category()), ptr);
+		aux::write_int64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			a.timestamp().time_since_epoch()).count(), ptr);
+
+		record_writer fields(buf.subspan(alert_export_header_size));
+
+		if (auto const* ta = dynamic_cast<torrent_alert const*>(&a))
+		{
+			info_hash_t const ih = ta->handle.info_hashes();
+			if (ih.has_v1()) fields.field(alert_field::info_hash_v1, ih.v1);
+			if (ih.has_v2()) fields.field(alert_field::info_hash_v2, ih.v2);
+
+			if (auto const* pa = dynamic_cast<peer_alert const*>(&a))
+			{
+				if (auto const* ep = std::get_if<aux::noexcept_movable<tcp::endpoint>>(&pa->ep))
+					fields.endpoint_field(alert_field::endpoint, *ep);
+				else if (auto const* dest = std::get_if<sha256_hash>(&pa->ep))
+					fields.field(alert_field::i2p_destination, *dest);
+				if (!pa->pid.is_all_zeros())
+					fields.field(alert_field::peer_id, pa->pid);
+			}
+			else if (auto const* tr = dynamic_cast<tracker_alert const*>(&a))
+			{
+				fields.string_field(alert_field::tracker_url, tr->tracker_url());
+				fields.endpoint_field(alert_field::local_endpoint, tr->local_endpoint);
+			}
+		}
+
+		type_fields(fields, a);
+		if (!fields.ok()) return 0;
+
+		int const size = int(fields.ptr() - start);
+		ptr = start;
+		aux::write_uint32(size, ptr);
+		return size;
+	}
+
+	int export_alerts(span<alert* const> const alerts, span<char>& buf)
+	{
+		int ret = 0;
+		for (alert const* a : alerts)
+		{
+			int const size = export_alert(*a, buf);
+			if (size == 0) break;
+			buf = buf.subspan(size);
+			++ret;
+		}
+		return ret;
+	}
+
+	span<char const> exported_alert::field(alert_field const f) const
+	{
+		span<char const> buf = fields;
+		while (buf.size() >= 3)
+		{
+			char const* ptr = buf.data();
+			auto const id = static_cast<alert_field>(aux::read_uint8(ptr));
+			int const len = aux::read_uint16(ptr);
+			if (buf.size() < 3 + len) break;
+			if (id == f) return {ptr, len};
+			buf = buf.subspan(3 + len);
+		}
+		return {};
+	}
+
+	int exported_alert::int_field(alert_field const f, int const def) const
+	{
+		span<char const> const v = field(f);
+		if (v.size() != 4) return def;
+		char const* ptr = v.data();
+		return aux::read_int32(ptr);
+	}
+
+	bool read_exported_alert(span<char const>& buf, exported_alert& out)
+	{
+		if (buf.size() < alert_export_header_size) return false;
+		char const* ptr = buf.data();
+		auto const size = std::ptrdiff_t(aux::read_uint32(ptr));
+		if (size < alert_export_header_size || size > buf.size()) return false;
+		out.type = aux::read_uint16(ptr);
+		// the version and reserved bytes
+		ptr += 2;
+		out.category = alert_category_t(aux::read_uint32(ptr));
+		out.timestamp = aux::read_int64(ptr);
+		out.fields = buf.subspan(alert_export_header_size, size - alert_export_header_size);
+		buf = buf.subspan(size);
+		return true;
+	}
+}
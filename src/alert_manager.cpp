@@ -30,6 +30,8 @@ namespace libtorrent::aux {
 
 	bool alert_manager::wait_for_alert(time_duration max_wait)
 	{
+		if (m_num_queued.load(std::memory_order_acquire) > 0) return true;
+
 		std::unique_lock<std::recursive_mutex> lock(m_mutex);
 
 		if (!m_alerts[m_generation & 1].empty()) return true;
@@ -81,32 +83,43 @@ namespace libtorrent::aux {
 
 	void alert_manager::get_all(std::vector<alert*>& alerts)
 	{
-		std::lock_guard<std::recursive_mutex> lock(m_mutex);
+		std::lock_guard<std::mutex> pop_lock(m_pop_mutex);
 
-		if (m_alerts[m_generation & 1].empty())
+		if (m_num_queued.load(std::memory_order_acquire) == 0)
 		{
 			alerts.clear();
 			return;
 		}
 
-		if (m_dropped.any()) {
-			emplace_alert<alerts_dropped_alert>(m_dropped);
-			m_dropped.reset();
-		}
+		// the alerts handed out by the previous call are owned by this thread.
+		// They are destructed here, before taking m_mutex, to not hold up the
+		// threads posting alerts. Once the generation is bumped, this is the
+		// queue new alerts are posted to. m_generation is only ever written
+		// by this function, under m_pop_mutex, so it's safe to read here.
+		std::uint32_t const next_generation = m_generation + 1;
+		m_alerts[next_generation & 1].clear();
+		m_allocations[next_generation & 1].reset(next_generation);
+
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
-		m_alerts[m_generation & 1].get_pointers(alerts);
+			if (m_dropped.any()) {
+				emplace_alert<alerts_dropped_alert>(m_dropped);
+				m_dropped.reset();
+			}
 
-		// swap buffers
-		m_generation += 1;
-		// clear the one we will start writing to now
-		m_alerts[m_generation & 1].clear();
-		m_allocations[m_generation & 1].reset(m_generation);
+			// swap buffers
+			m_generation = next_generation;
+			m_num_queued.store(0, std::memory_order_relaxed);
+		}
+
+		// the queue we just swapped out is now exclusively owned by this thread
+		m_alerts[(next_generation - 1) & 1].get_pointers(alerts);
 	}
 
 	bool alert_manager::pending() const
 	{
-		std::lock_guard<std::recursive_mutex> lock(m_mutex);
-		return !m_alerts[m_generation & 1].empty();
+		return m_num_queued.load(std::memory_order_acquire) > 0;
 	}
 
 	int alert_manager::set_alert_queue_size_limit(int queue_size_limit_)
@@ -130,7 +130,12 @@ namespace libtorrent::aux {
 
 		std::vector<bw_request> queue;
 
-		for (auto i = m_queue.begin(); i != m_queue.end();)
+		// requests that are done are moved out of m_queue while the remaining
+		// ones are compacted in place, preserving their order. Erasing them
+		// one at a time would make a tick quadratic in the number of queued
+		// requests
+		auto out = m_queue.begin();
+		for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
 		{
 			if (i->peer->is_disconnecting())
 			{
@@ -146,7 +151,6 @@ namespace libtorrent::aux {
 
 				i->assigned = 0;
 				queue.push_back(std::move(*i));
-				i = m_queue.erase(i);
 				continue;
 			}
 			for (int j = 0; j < bw_request::max_bandwidth_channels && i->channel[j]; ++j)
@@ -154,8 +158,10 @@ namespace libtorrent::aux {
 				bandwidth_channel* bwc = i->channel[j];
 				bwc->tmp = 0;
 			}
-			++i;
+			if (out != i) *out = std::move(*i);
+			++out;
 		}
+		m_queue.erase(out, m_queue.end());
 
 		for (auto const& r : m_queue)
 		{
@@ -173,7 +179,8 @@ namespace libtorrent::aux {
 			ch->update_quota(int(dt_milliseconds));
 		}
 
-		for (auto i = m_queue.begin(); i != m_queue.end();)
+		out = m_queue.begin();
+		for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
 		{
 			int a = i->assign_bandwidth();
 			if (i->assigned == i->request_size
@@ -182,14 +189,15 @@ namespace libtorrent::aux {
 				a += i->request_size - i->assigned;
 				TORRENT_ASSERT(i->assigned <= i->request_size);
 				queue.push_back(std::move(*i));
-				i = m_queue.erase(i);
 			}
 			else
 			{
-				++i;
+				if (out != i) *out = std::move(*i);
+				++out;
 			}
 			m_queued_bytes -= a;
 		}
+		m_queue.erase(out, m_queue.end());
 
 		while (!queue.empty())
 		{
@@ -66,7 +66,25 @@ namespace libtorrent {
 #if TORRENT_HAS_SSE
 		if (aux::mmx_support)
 		{
-			for (int i = 1; i < words + 1; ++i)
+			int i = 1;
+#if defined __x86_64__ || defined _M_X64
+			// count two words at a time, with the 64 bit popcnt
+			for (; i + 1 < words + 1; i += 2)
+			{
+				std::uint64_t v;
+				std::memcpy(&v, &m_buf[i], sizeof(v));
+#ifdef __GNUC__
+				std::uint64_t cnt = 0;
+				__asm__("popcnt %1, %0"
+					: "=r"(cnt)
+					: "r"(v));
+				ret += int(cnt);
+#else
+				ret += int(_mm_popcnt_u64(v));
+#endif
+			}
+#endif
+			for (; i < words + 1; ++i)
 			{
 #ifdef __GNUC__
 				std::uint32_t cnt = 0;
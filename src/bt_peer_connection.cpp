@@ -537,7 +537,7 @@ namespace {
 			peer_log(peer_log_alert::info, peer_log_alert::encryption, "initiating encrypted handshake");
 #endif
 
-		m_dh_key_exchange.reset(new dh_key_exchange);
+		m_dh_key_exchange = m_ses.take_dh_key();
 
 		int const pad_size = int(random(512));
 
@@ -2981,7 +2981,9 @@ namespace {
 			TORRENT_ASSERT(!is_disconnecting());
 
 			sha1_hash ih(recv_buffer.data());
-			aux::torrent const* ti = m_ses.find_encrypted_torrent(ih, m_dh_key_exchange->get_hash_xor_mask());
+			protocol_version matched_version = protocol_version::V1;
+			aux::torrent const* ti = m_ses.find_encrypted_torrent(ih
+				, m_dh_key_exchange->get_hash_xor_mask(), matched_version);
 
 			if (ti)
 			{
@@ -2995,20 +2997,10 @@ namespace {
 					TORRENT_ASSERT(t);
 				}
 
-				// compute the obfuscated hash of the torrent's valid info hashes
-				// to find the one which matches the received hash
-
-				sha1_hash oih(ih);
-				oih ^= m_dh_key_exchange->get_hash_xor_mask();
-
-				t->info_hash().for_each([&](sha1_hash const& tih, protocol_version v)
-				{
-					static char const req2[4] = { 'r', 'e', 'q', '2' };
-					hasher h(req2);
-					h.update(tih);
-					if (h.final() == oih)
-						peer_info_struct()->protocol_v2 = v == protocol_version::V2;
-				});
+				// the obfuscated hash index also tells us which of the
+				// torrent's info hashes the peer asked for
+				if (t.get() == ti)
+					peer_info_struct()->protocol_v2 = matched_version == protocol_version::V2;
 
 				m_rc4 = init_pe_rc4_handler(m_dh_key_exchange->get_secret()
 					, associated_info_hash(), is_outgoing());
@@ -17,107 +17,28 @@ see LICENSE file.
 #include "libtorrent/aux_/time.hpp"
 #include "libtorrent/aux_/torrent.hpp"
 
-#include <functional>
-
-using namespace std::placeholders;
+#include <algorithm>
+#include <cstdlib> // for abs
 
 namespace libtorrent::aux {
 
 namespace {
 
-	int compare_peers(peer_connection const* lhs, peer_connection const* rhs)
-	{
-		int const prio1 = lhs->get_priority(peer_connection::upload_channel);
-		int const prio2 = rhs->get_priority(peer_connection::upload_channel);
-
-		if (prio1 != prio2) return prio1 > prio2 ? 1 : -1;
-
-		// compare how many bytes they've sent us
-		std::int64_t const c1 = lhs->downloaded_in_last_round();
-		std::int64_t const c2 = rhs->downloaded_in_last_round();
-
-		if (c1 != c2) return c1 > c2 ? 1 : -1;
-		return 0;
-	}
-
-	// return true if 'lhs' peer should be preferred to be unchoke over 'rhs'
-	bool unchoke_compare_rr(peer_connection const* lhs
-		, peer_connection const* rhs, int pieces)
+	// the number of bytes a peer has to receive from us since it was
+	// unchoked before the round-robin unchoker lets another peer have its
+	// slot. Peers that are choked never have their quota complete
+	bool quota_complete(peer_connection const* p, torrent const& t
+		, int const pieces, time_point const now)
 	{
-		int const cmp = compare_peers(lhs, rhs);
-		if (cmp != 0) return cmp > 0;
-
-		// when seeding, rotate which peer is unchoked in a round-robin fashion
-
-		// the amount uploaded since unchoked (not just in the last round)
-		std::int64_t const u1 = lhs->uploaded_since_unchoked();
-		std::int64_t const u2 = rhs->uploaded_since_unchoked();
-
-		// the way the round-robin unchoker works is that it,
-		// by default, prioritizes any peer that is already unchoked.
-		// this maintain the status quo across unchoke rounds. However,
-		// peers that are unchoked, but have sent more than one quota
-		// since they were unchoked, they get de-prioritized.
-
-		auto const t1 = lhs->associated_torrent().lock();
-		auto const t2 = rhs->associated_torrent().lock();
-		TORRENT_ASSERT(t1);
-		TORRENT_ASSERT(t2);
-
 		// if a peer is already unchoked, the number of bytes sent since it was unchoked
 		// is greater than the send quanta, and it has been unchoked for at least one minute
 		// then it's done with its upload slot, and we can de-prioritize it
-		bool const c1_quota_complete = !lhs->is_choked()
-			&& u1 > std::int64_t(t1->torrent_file().piece_length()) * pieces
-			&& aux::time_now() - lhs->time_of_last_unchoke() > minutes(1);
-		bool const c2_quota_complete = !rhs->is_choked()
-			&& u2 > std::int64_t(t2->torrent_file().piece_length()) * pieces
-			&& aux::time_now() - rhs->time_of_last_unchoke() > minutes(1);
-
-		// if c2 has completed a quanta, it should be de-prioritized
-		// and vice versa
-		if (c1_quota_complete != c2_quota_complete)
-			return int(c1_quota_complete) < int(c2_quota_complete);
-
-		// when seeding, prefer the peer we're uploading the fastest to
-
-		// force the upload rate to zero for choked peers because
-		// if the peers just got choked the previous round
-		// there may have been a residual transfer which was already
-		// in-flight at the time and we don't want that to cause the peer
-		// to be ranked at the top of the choked peers
-		std::int64_t const c1 = lhs->is_choked() ? 0 : lhs->uploaded_in_last_round();
-		std::int64_t const c2 = rhs->is_choked() ? 0 : rhs->uploaded_in_last_round();
-
-		if (c1 != c2) return c1 > c2;
-
-		// if the peers are still identical (say, they're both waiting to be unchoked)
-		// prioritize the one that has waited the longest to be unchoked
-		// the round-robin unchoker relies on this logic. Don't change it
-		// without moving this into that unchoker logic
-		return lhs->time_of_last_unchoke() < rhs->time_of_last_unchoke();
+		return !p->is_choked()
+			&& p->uploaded_since_unchoked() > std::int64_t(t.torrent_file().piece_length()) * pieces
+			&& now - p->time_of_last_unchoke() > minutes(1);
 	}
 
-	// return true if 'lhs' peer should be preferred to be unchoke over 'rhs'
-	bool unchoke_compare_fastest_upload(peer_connection const* lhs
-		, peer_connection const* rhs)
-	{
-		int const cmp = compare_peers(lhs, rhs);
-		if (cmp != 0) return cmp > 0;
-
-		// when seeding, prefer the peer we're uploading the fastest to
-		std::int64_t const c1 = lhs->uploaded_in_last_round();
-		std::int64_t const c2 = rhs->uploaded_in_last_round();
-
-		if (c1 != c2) return c1 > c2;
-
-		// prioritize the one that has waited the longest to be unchoked
-		// the round-robin unchoker relies on this logic. Don't change it
-		// without moving this into that unchoker logic
-		return lhs->time_of_last_unchoke() < rhs->time_of_last_unchoke();
-	}
-
-	int anti_leech_score(peer_connection const* peer)
+	int anti_leech_score(peer_connection const* peer, torrent const& t)
 	{
 		// the anti-leech seeding algorithm is based on the paper "Improving
 		// BitTorrent: A Simple Approach" from Chow et. al. and ranks peers based
@@ -139,49 +60,74 @@ namespace {
 		//   |             V             |
 		//   +---------------------------+
 		//   0%    num have pieces     100%
-		std::shared_ptr<torrent> const t = peer->associated_torrent().lock();
-		TORRENT_ASSERT(t);
-
-		std::int64_t const total_size = t->torrent_file().total_size();
+		std::int64_t const total_size = t.torrent_file().total_size();
 		if (total_size == 0) return 0;
 		// Cap the given_size so that it never causes the score to increase
 		std::int64_t const given_size = std::min(peer->statistics().total_payload_upload()
 			, total_size / 2);
 		std::int64_t const have_size = std::max(given_size
-			, std::int64_t(t->torrent_file().piece_length()) * peer->num_have_pieces());
+			, std::int64_t(t.torrent_file().piece_length()) * peer->num_have_pieces());
 		return int(std::abs((have_size - total_size / 2) * 2000 / total_size));
 	}
 
-	// return true if 'lhs' peer should be preferred to be unchoke over 'rhs'
-	bool unchoke_compare_anti_leech(peer_connection const* lhs
-		, peer_connection const* rhs)
+	} // anonymous namespace
+
+	bool unchoke_candidate::operator<(unchoke_candidate const& rhs) const
 	{
-		int const cmp = compare_peers(lhs, rhs);
-		if (cmp != 0) return cmp > 0;
+		if (priority != rhs.priority) return priority > rhs.priority;
+
+		// compare how many bytes they've sent us
+		if (downloaded != rhs.downloaded) return downloaded > rhs.downloaded;
+
+		// if rhs has completed a quanta, it should be de-prioritized
+		// and vice versa
+		if (quota_complete != rhs.quota_complete)
+			return int(quota_complete) < int(rhs.quota_complete);
 
-		int const score1 = anti_leech_score(lhs);
-		int const score2 = anti_leech_score(rhs);
-		if (score1 != score2) return score1 > score2;
+		// requests for pieces in memory are cheaper to serve
+		if (cached_requests != rhs.cached_requests) return cached_requests;
 
+		if (score != rhs.score) return score > rhs.score;
+
+		// if the peers are still identical (say, they're both waiting to be unchoked)
 		// prioritize the one that has waited the longest to be unchoked
 		// the round-robin unchoker relies on this logic. Don't change it
 		// without moving this into that unchoker logic
-		return lhs->time_of_last_unchoke() < rhs->time_of_last_unchoke();
+		return last_unchoke < rhs.last_unchoke;
 	}
 
-	bool upload_rate_compare(peer_connection const* lhs
-		, peer_connection const* rhs)
+	void select_unchoke_candidates(span<unchoke_candidate> const candidates, int const slots)
 	{
-		// take torrent priority into account
-		std::int64_t const c1 = lhs->uploaded_in_last_round()
-			* lhs->get_priority(peer_connection::upload_channel);
-		std::int64_t const c2 = rhs->uploaded_in_last_round()
-			* rhs->get_priority(peer_connection::upload_channel);
-
-		return c1 > c2;
+		TORRENT_ASSERT(slots >= 0);
+		if (slots >= candidates.size()) return;
+		std::nth_element(candidates.begin(), candidates.begin() + slots, candidates.end());
 	}
 
-	} // anonymous namespace
+	int rate_based_unchoke_slots(span<std::pair<std::int64_t, int>> const rates
+		, int rate_threshold)
+	{
+		// this is a max-heap on the first element, the upload rate weighted
+		// by priority. We only need to pop peers off it until we reach one
+		// that's below the threshold, which typically is much fewer than all
+		// of them
+		std::make_heap(rates.begin(), rates.end());
+
+		int upload_slots = 0;
+		for (auto end = rates.end(); end != rates.begin(); --end)
+		{
+			std::pop_heap(rates.begin(), end);
+			int const rate = (end - 1)->second;
+
+			// always have at least 1 unchoke slot
+			if (rate < rate_threshold) break;
+
+			++upload_slots;
+
+			// TODO: make configurable
+			rate_threshold += 2048;
+		}
+		return upload_slots + 1;
+	}
 
 	int unchoke_sort(std::vector<peer_connection*>& peers
 		, time_duration const unchoke_interval
@@ -212,30 +158,20 @@ namespace {
 		if (sett.get_int(settings_pack::choking_algorithm)
 			== settings_pack::rate_based_choker)
 		{
-			// first reset the number of unchoke slots, because we'll calculate
-			// it purely based on the current state of our peers.
-			upload_slots = 0;
-
-			int rate_threshold = sett.get_int(settings_pack::rate_choker_initial_threshold);
-
-			std::sort(peers.begin(), peers.end()
-				, [](peer_connection const* lhs, peer_connection const* rhs)
-				{ return upload_rate_compare(lhs, rhs); });
-
+			std::vector<std::pair<std::int64_t, int>> rates;
+			rates.reserve(peers.size());
 			for (auto const* p : peers)
 			{
-				int const rate = int(p->uploaded_in_last_round()
-					* 1000 / total_milliseconds(unchoke_interval));
-
-				// always have at least 1 unchoke slot
-				if (rate < rate_threshold) break;
-
-				++upload_slots;
-
-				// TODO: make configurable
-				rate_threshold += 2048;
+				// take torrent priority into account
+				rates.emplace_back(p->uploaded_in_last_round()
+					* p->get_priority(peer_connection::upload_channel)
+					, int(p->uploaded_in_last_round() * 1000 / total_milliseconds(unchoke_interval)));
 			}
-			++upload_slots;
+
+			// the number of unchoke slots is calculated purely based on the
+			// current state of our peers.
+			upload_slots = rate_based_unchoke_slots(rates
+				, sett.get_int(settings_pack::rate_choker_initial_threshold));
 		}
 
 		// sorts the peers that are eligible for unchoke by download rate and
@@ -243,38 +179,77 @@ namespace {
 		// being seeded, the download rate will be 0, and the peers we have sent
 		// the least to should be unchoked
 
-		// we use partial sort here, because we only care about the top
-		// upload_slots peers.
+		// the keys are gathered up-front, once per peer. The comparisons
+		// then only touch this compact array, instead of following pointers
+		// into every peer_connection (and its torrent) each time
 
 		int const slots = std::min(upload_slots, int(peers.size()));
 		int const seed_choke = sett.get_int(settings_pack::seed_choking_algorithm);
-
-		if (seed_choke == settings_pack::fastest_upload)
+		int const pieces = sett.get_int(settings_pack::seeding_piece_quota);
+		time_point const now = aux::time_now();
+		bool const suggest_cache = sett.get_int(settings_pack::suggest_mode)
+			== settings_pack::suggest_read_cache;
+
+		std::vector<unchoke_candidate> candidates;
+		candidates.reserve(peers.size());
+		for (auto* p : peers)
 		{
-			std::nth_element(peers.begin(), peers.begin()
-				+ slots, peers.end()
-				, [](peer_connection const* lhs, peer_connection const* rhs)
-				{ return unchoke_compare_fastest_upload(lhs, rhs); });
-		}
-		else if (seed_choke == settings_pack::anti_leech)
-		{
-			std::nth_element(peers.begin(), peers.begin()
-				+ slots, peers.end()
-				, [](peer_connection const* lhs, peer_connection const* rhs)
-				{ return unchoke_compare_anti_leech(lhs, rhs); });
-		}
-		else
-		{
-			TORRENT_ASSERT(seed_choke == settings_pack::round_robin);
-			int const pieces = sett.get_int(settings_pack::seeding_piece_quota);
-			std::nth_element(peers.begin(),
-				peers.begin() + slots,
-				peers.end(),
-				[pieces](peer_connection const* lhs, peer_connection const* rhs) {
-					return unchoke_compare_rr(lhs, rhs, pieces);
-				});
+			unchoke_candidate c;
+			c.peer = p;
+			c.priority = p->get_priority(peer_connection::upload_channel);
+			c.downloaded = p->downloaded_in_last_round();
+			c.last_unchoke = p->time_of_last_unchoke();
+
+			if (suggest_cache)
+			{
+				auto const t = p->associated_torrent().lock();
+				TORRENT_ASSERT(t);
+				auto const& q = p->upload_queue();
+				c.cached_requests = std::any_of(q.begin(), q.end()
+					, [&](peer_request const& r) { return t->is_piece_cached(r.piece); });
+			}
+
+			if (seed_choke == settings_pack::fastest_upload)
+			{
+				// when seeding, prefer the peer we're uploading the fastest to
+				c.score = p->uploaded_in_last_round();
+			}
+			else if (seed_choke == settings_pack::anti_leech)
+			{
+				auto const t = p->associated_torrent().lock();
+				TORRENT_ASSERT(t);
+				c.score = anti_leech_score(p, *t);
+			}
+			else
+			{
+				TORRENT_ASSERT(seed_choke == settings_pack::round_robin);
+
+				// when seeding, rotate which peer is unchoked in a round-robin
+				// fashion. The way the round-robin unchoker works is that it,
+				// by default, prioritizes any peer that is already unchoked.
+				// this maintain the status quo across unchoke rounds. However,
+				// peers that are unchoked, but have sent more than one quota
+				// since they were unchoked, they get de-prioritized.
+				auto const t = p->associated_torrent().lock();
+				TORRENT_ASSERT(t);
+				c.quota_complete = quota_complete(p, *t, pieces, now);
+
+				// then prefer the peer we're uploading the fastest to. Force
+				// the upload rate to zero for choked peers because if the
+				// peers just got choked the previous round there may have been
+				// a residual transfer which was already in-flight at the time
+				// and we don't want that to cause the peer to be ranked at the
+				// top of the choked peers
+				c.score = p->is_choked() ? 0 : p->uploaded_in_last_round();
+			}
+			candidates.push_back(c);
 		}
 
+		select_unchoke_candidates(candidates, slots);
+
+		for (std::size_t i = 0; i < candidates.size(); ++i)
+			peers[i] = candidates[i].peer;
+
 		return upload_slots;
 	}
 
@@ -0,0 +1,113 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "libtorrent/config.hpp"
+
+#if !defined TORRENT_DISABLE_ENCRYPTION
+
+#include "libtorrent/aux_/dh_key_pool.hpp"
+#include "libtorrent/aux_/platform_util.hpp" // for set_thread_name
+
+#include <algorithm>
+
+namespace libtorrent::aux {
+
+	dh_key_pool::dh_key_pool() = default;
+
+	dh_key_pool::~dh_key_pool()
+	{
+		abort();
+	}
+
+	void dh_key_pool::set_size(int const size)
+	{
+		std::unique_lock<std::mutex> l(m_mutex);
+		if (m_abort) return;
+		m_size = std::max(0, size);
+		if (int(m_keys.size()) > m_size) m_keys.resize(std::size_t(m_size));
+		if (m_size > 0 && !m_thread.joinable())
+			m_thread = std::thread([this] { thread_fun(); });
+		l.unlock();
+		m_cond.notify_one();
+	}
+
+	std::unique_ptr<dh_key_exchange> dh_key_pool::take()
+	{
+		{
+			std::unique_lock<std::mutex> l(m_mutex);
+			if (!m_keys.empty())
+			{
+				std::unique_ptr<dh_key_exchange> ret = std::move(m_keys.back());
+				m_keys.pop_back();
+				l.unlock();
+				m_cond.notify_one();
+				return ret;
+			}
+		}
+		// the pool has run dry (or is disabled). Don't make the caller wait
+		// for the background thread to catch up
+		return std::make_unique<dh_key_exchange>();
+	}
+
+	void dh_key_pool::abort()
+	{
+		{
+			std::lock_guard<std::mutex> l(m_mutex);
+			m_abort = true;
+			m_keys.clear();
+		}
+		m_cond.notify_all();
+		if (m_thread.joinable()) m_thread.join();
+	}
+
+	int dh_key_pool::num_ready() const
+	{
+		std::lock_guard<std::mutex> l(m_mutex);
+		return int(m_keys.size());
+	}
+
+	void dh_key_pool::thread_fun()
+	{
+		set_thread_name("libtorrent-dh-keys");
+
+		std::unique_lock<std::mutex> l(m_mutex);
+		for (;;)
+		{
+			m_cond.wait(l, [this] { return m_abort || int(m_keys.size()) < m_size; });
+			if (m_abort) break;
+
+			// the expensive part is done without holding the mutex, to not
+			// block the network thread from picking up the keys that are
+			// already ready
+			l.unlock();
+			std::unique_ptr<dh_key_exchange> key;
+			try
+			{
+				key = std::make_unique<dh_key_exchange>();
+			}
+			catch (std::exception const&)
+			{
+				// failing to allocate here is not fatal, take() will just
+				// have to generate keys inline. Stop precomputing rather than
+				// spinning on the failure, until the pool size is set again
+			}
+			l.lock();
+
+			if (!key)
+			{
+				m_size = 0;
+				continue;
+			}
+			if (int(m_keys.size()) < m_size)
+				m_keys.push_back(std::move(key));
+		}
+	}
+}
+
+#endif // TORRENT_DISABLE_ENCRYPTION
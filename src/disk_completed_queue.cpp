@@ -14,6 +14,7 @@ see LICENSE file.
 #include "libtorrent/aux_/disk_job.hpp"
 #include "libtorrent/aux_/debug_disk_thread.hpp"
 #include "libtorrent/aux_/array.hpp"
+#include "libtorrent/aux_/handler_trace.hpp"
 #if TORRENT_DISK_LATENCY_STATS
 #include "libtorrent/time.hpp" // for clock_type, total_milliseconds
 #include <cstdint>
@@ -92,6 +93,7 @@ void disk_completed_queue::append(io_context& ioc, jobqueue_t jobs)
 // This is run in the network thread
 void disk_completed_queue::call_job_handlers()
 {
+	TORRENT_TRACE_SCOPE("disk_completed_queue::call_job_handlers");
 	m_stats_counters.inc_stats_counter(counters::on_disk_counter);
 	std::unique_lock<std::mutex> l(m_completed_jobs_mutex);
 
@@ -332,6 +332,22 @@ namespace libtorrent::aux {
 		return ret;
 	}
 
+	template <typename FileEntry>
+	std::vector<std::pair<file_index_t, typename file_pool_impl<FileEntry>::FileHandle>>
+	file_pool_impl<FileEntry>::open_files(storage_index_t const st) const
+	{
+		std::vector<std::pair<file_index_t, FileHandle>> ret;
+		std::unique_lock<std::mutex> l(m_mutex);
+
+		auto const& key_view = m_files. template get<0>();
+		auto const start = key_view.lower_bound(file_id{st, file_index_t(0)});
+		auto const end = key_view.upper_bound(file_id{st, std::numeric_limits<file_index_t>::max()});
+
+		for (auto i = start; i != end; ++i)
+			ret.emplace_back(i->key.second, i->mapping);
+		return ret;
+	}
+
 	template <typename FileEntry>
 	typename file_pool_impl<FileEntry>::FileHandle
 	file_pool_impl<FileEntry>::remove_oldest(std::unique_lock<std::mutex>&)
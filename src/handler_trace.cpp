@@ -0,0 +1,151 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "libtorrent/handler_trace.hpp"
+#include "libtorrent/aux_/handler_trace.hpp"
+
+#include <array>
+#include <cinttypes> // for PRId64
+#include <cstdint>
+#include <cstdio> // for snprintf
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace libtorrent {
+
+namespace aux {
+
+namespace {
+
+	struct trace_event
+	{
+		char const* name;
+		// nanoseconds since the clock's epoch
+		std::int64_t start;
+		std::int64_t duration;
+	};
+
+	// the events recorded by one thread. The mutex is only contended while
+	// the trace is being exported or cleared
+	struct trace_ring
+	{
+		explicit trace_ring(int const id) : tid(id) {}
+
+		std::mutex mutex;
+
+		// the total number of events recorded into this ring. The most recent
+		// events are at (count - 1) % trace_ring_size and backwards
+		std::uint64_t count = 0;
+		std::array<trace_event, trace_ring_size> events;
+		int const tid;
+	};
+
+	// every thread that has recorded an event. Rings outlive their threads,
+	// to still be exported after a session's network thread has exited
+	struct trace_registry
+	{
+		std::mutex mutex;
+		std::vector<std::shared_ptr<trace_ring>> rings;
+	};
+
+	trace_registry& registry()
+	{
+		static trace_registry r;
+		return r;
+	}
+
+	trace_ring& thread_ring()
+	{
+		thread_local std::shared_ptr<trace_ring> const ring = []
+		{
+			trace_registry& reg = registry();
+			std::lock_guard<std::mutex> l(reg.mutex);
+			auto r = std::make_shared<trace_ring>(int(reg.rings.size()) + 1);
+			reg.rings.push_back(r);
+			return r;
+		}();
+		return *ring;
+	}
+
+	std::vector<std::shared_ptr<trace_ring>> all_rings()
+	{
+		trace_registry& reg = registry();
+		std::lock_guard<std::mutex> l(reg.mutex);
+		return reg.rings;
+	}
+
+	std::int64_t nanoseconds_since_epoch(time_point const t)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			t.time_since_epoch()).count();
+	}
+
+	void escape_json(std::string& out, char const* str)
+	{
+		for (; *str != '\0'; ++str)
+		{
+			if (*str == '"' || *str == '\\') out += '\\';
+			out += *str;
+		}
+	}
+} // anonymous namespace
+
+	void record_trace_event(char const* const name
+		, time_point const start, time_point const end)
+	{
+		trace_ring& r = thread_ring();
+		std::lock_guard<std::mutex> l(r.mutex);
+		trace_event& e = r.events[std::size_t(r.count % trace_ring_size)];
+		e.name = name;
+		e.start = nanoseconds_since_epoch(start);
+		e.duration = nanoseconds_since_epoch(end) - e.start;
+		++r.count;
+	}
+} // namespace aux
+
+	std::string handler_trace_json()
+	{
+		std::string ret = "{\"traceEvents\":[";
+		bool first = true;
+		char buf[200];
+		for (auto const& r : aux::all_rings())
+		{
+			std::lock_guard<std::mutex> l(r->mutex);
+			std::uint64_t const begin = r->count > aux::trace_ring_size
+				? r->count - aux::trace_ring_size : 0;
+			for (std::uint64_t i = begin; i < r->count; ++i)
+			{
+				aux::trace_event const& e = r->events[std::size_t(i % aux::trace_ring_size)];
+				if (!first) ret += ',';
+				first = false;
+				ret += "\n{\"name\":\"";
+				aux::escape_json(ret, e.name);
+				// timestamps are in microseconds, with nanosecond precision
+				std::snprintf(buf, sizeof(buf)
+					, "\",\"ph\":\"X\",\"ts\":%" PRId64 ".%03d,\"dur\":%" PRId64 ".%03d"
+					",\"pid\":1,\"tid\":%d}"
+					, e.start / 1000, int(e.start % 1000)
+					, e.duration / 1000, int(e.duration % 1000), r->tid);
+				ret += buf;
+			}
+		}
+		ret += "\n],\"displayTimeUnit\":\"ms\"}\n";
+		return ret;
+	}
+
+	void clear_handler_trace()
+	{
+		for (auto const& r : aux::all_rings())
+		{
+			std::lock_guard<std::mutex> l(r->mutex);
+			r->count = 0;
+		}
+	}
+}
@@ -30,6 +30,7 @@ see LICENSE file.
 #include <sys/mman.h> // for mmap
 #include <sys/stat.h>
 #include <fcntl.h> // for open
+#include <unistd.h> // for sysconf
 
 #include "libtorrent/aux_/disable_warnings_push.hpp"
 auto const map_failed = MAP_FAILED;
@@ -313,6 +314,34 @@ void file_mapping::page_out(span<byte const> range)
 #endif // MAP_VIEW_OF_FILE
 }
 
+int file_mapping::resident_pages(std::vector<std::uint8_t>& pages) const
+{
+	pages.clear();
+#if TORRENT_HAVE_MMAP
+	if (m_mapping == nullptr || m_size <= 0) return 0;
+
+	long const page_size = ::sysconf(_SC_PAGESIZE);
+	if (page_size <= 0) return 0;
+
+	pages.resize(std::size_t((m_size + page_size - 1) / page_size));
+#ifdef TORRENT_LINUX
+	auto* const vec = pages.data();
+#else
+	auto* const vec = reinterpret_cast<char*>(pages.data());
+#endif
+	if (::mincore(m_mapping, static_cast<std::size_t>(m_size), vec) != 0)
+	{
+		pages.clear();
+		return 0;
+	}
+	// only the lowest bit indicates residency
+	for (auto& p : pages) p &= 1;
+	return int(page_size);
+#else
+	return 0;
+#endif
+}
+
 } // aux
 } // libtorrent
 
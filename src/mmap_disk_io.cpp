@@ -52,6 +52,7 @@ see LICENSE file.
 #endif
 
 #include <functional>
+#include <algorithm>
 
 #include "libtorrent/aux_/debug_disk_thread.hpp"
 
@@ -132,6 +133,7 @@ struct TORRENT_EXTRA_EXPORT mmap_disk_io final
 	void update_stats_counters(counters& c) const override;
 
 	std::vector<open_file_state> get_status(storage_index_t) const override;
+	typed_bitfield<piece_index_t> cached_pieces(storage_index_t) const override;
 
 	// this submits all queued up jobs to the thread
 	void submit_jobs() override;
@@ -267,6 +269,71 @@ TORRENT_EXPORT std::unique_ptr<disk_interface> mmap_disk_io_constructor(
 		return m_file_pool.get_status(st);
 	}
 
+	typed_bitfield<piece_index_t> mmap_disk_io::cached_pieces(storage_index_t const st) const
+	{
+		auto const& storage = m_torrents[st];
+		if (!storage) return {};
+		file_storage const& fs = storage->files();
+		std::int64_t const piece_length = fs.piece_length();
+
+		// the number of bytes of every piece found to be in memory. A piece is
+		// cached once all of its bytes are. Files that aren't open (or too
+		// small to be mapped) are assumed not to be
+		aux::vector<int, piece_index_t> resident(fs.num_pieces(), 0);
+
+		auto add_range = [&](std::int64_t const offset, std::int64_t const size
+			, auto&& is_resident)
+		{
+			if (size <= 0) return;
+			piece_index_t const first(int(offset / piece_length));
+			piece_index_t const last(int((offset + size - 1) / piece_length));
+			for (piece_index_t p = first; p <= last; ++p)
+			{
+				std::int64_t const start = std::max(offset
+					, std::int64_t(static_cast<int>(p)) * piece_length);
+				std::int64_t const end = std::min(offset + size
+					, std::int64_t(static_cast<int>(p) + 1) * piece_length);
+				if (is_resident(start - offset, end - offset))
+					resident[p] += int(end - start);
+			}
+		};
+
+		// pad files are never read from disk
+		for (auto const f : fs.file_range())
+		{
+			if (!fs.pad_file_at(f)) continue;
+			add_range(fs.file_offset(f), fs.file_size(f)
+				, [](std::int64_t, std::int64_t) { return true; });
+		}
+
+		std::vector<std::uint8_t> pages;
+		for (auto const& of : m_file_pool.open_files(st))
+		{
+			file_index_t const f = of.first;
+			if (!of.second->has_memory_map()) continue;
+			std::int64_t const page_size = of.second->resident_pages(pages);
+			if (page_size == 0) continue;
+
+			add_range(fs.file_offset(f), fs.file_size(f)
+				, [&](std::int64_t const start, std::int64_t const end)
+			{
+				auto const first_page = std::size_t(start / page_size);
+				auto const last_page = std::size_t((end - 1) / page_size);
+				if (last_page >= pages.size()) return false;
+				return std::all_of(pages.begin() + std::ptrdiff_t(first_page)
+					, pages.begin() + std::ptrdiff_t(last_page) + 1
+					, [](std::uint8_t const v) { return v != 0; });
+			});
+		}
+
+		typed_bitfield<piece_index_t> ret(fs.num_pieces(), false);
+		for (auto const p : fs.piece_range())
+		{
+			if (resident[p] == fs.piece_size(p)) ret.set_bit(p);
+		}
+		return ret;
+	}
+
 	storage_holder mmap_disk_io::new_torrent(storage_params const& params
 		, std::shared_ptr<void> const& owner)
 	{
@@ -512,21 +512,18 @@ namespace {
 		{
 			t->need_picker();
 			piece_picker const& p = t->picker();
-			piece_index_t const end_piece(p.num_pieces());
-			for (piece_index_t j(0); j != end_piece; ++j)
+			// only the pieces the peer has are visited, skipping 32 pieces
+			// at a time where it has none of them
+			interested = m_have_piece.for_each_set_bit([&](piece_index_t const j)
 			{
-				if (m_have_piece[j]
-					&& t->piece_priority(j) > dont_download
-					&& !p.have_piece(j))
-				{
-					interested = true;
+				if (p.have_piece(j) || t->piece_priority(j) == dont_download)
+					return false;
 #ifndef TORRENT_DISABLE_LOGGING
-					peer_log(peer_log_alert::info, peer_log_alert::update_interest, "interesting, piece: %d"
-						, static_cast<int>(j));
+				peer_log(peer_log_alert::info, peer_log_alert::update_interest, "interesting, piece: %d"
+					, static_cast<int>(j));
 #endif
-					break;
-				}
-			}
+				return true;
+			});
 		}
 
 #ifndef TORRENT_DISABLE_LOGGING
@@ -2926,6 +2923,12 @@ namespace {
 		TORRENT_ASSERT_VAL(m_received_in_piece == p.length, m_received_in_piece);
 		m_received_in_piece = 0;
 #endif
+		if (b->request_time != time_point{})
+		{
+			m_counters.add_histogram_sample(counters::block_request_rtt_hist
+				, total_microseconds(now - b->request_time));
+		}
+
 		// if the block we got is already finished, then ignore it
 		if (picker.is_downloaded(block_finished))
 		{
@@ -5646,13 +5649,6 @@ namespace {
 
 		m_counters.blend_stats_counter(counters::request_latency, disk_rtt, 5);
 
-		// we probably just pulled this piece into the cache.
-		// if it's rare enough to make it into the suggested piece
-		// push another piece out
-		if (m_settings.get_int(settings_pack::suggest_mode) == settings_pack::suggest_read_cache)
-		{
-			t->add_suggest_piece(r.piece);
-		}
 		write_piece(r, std::move(buffer));
 	}
 
@@ -6465,7 +6461,10 @@ namespace {
 			if (block.send_buffer_offset == pending_block::not_in_buffer)
 				continue;
 			if (block.send_buffer_offset < int(bytes_transferred))
+			{
 				block.send_buffer_offset = pending_block::not_in_buffer;
+				block.request_time = now;
+			}
 			else
 				block.send_buffer_offset -= int(bytes_transferred);
 		}
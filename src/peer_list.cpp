@@ -39,8 +39,6 @@ see LICENSE file.
 #include "libtorrent/aux_/socket_io.hpp" // for print_endpoint
 #endif
 
-using namespace std::placeholders;
-
 namespace {
 
 	using namespace libtorrent;
@@ -84,38 +82,39 @@ namespace {
 		return lhs.trust_points < rhs.trust_points;
 	}
 
-	// this returns true if lhs is a better connect candidate than rhs
-	bool compare_peer(aux::torrent_peer const* lhs, aux::torrent_peer const* rhs
+	// returns the priority of p as a connect candidate. A peer with a higher
+	// priority is a better candidate. The fields are packed most significant
+	// first, in the order they're considered:
+	// lower failcount, local peers, peers we connected to longer ago, (when
+	// we're finished) peers that aren't seeds, source rank, peer rank
+	std::uint64_t connect_priority(aux::torrent_peer const& p
 		, aux::external_ip const& external, int const external_port, bool const finished)
 	{
-		// prefer peers with lower failcount
-		if (lhs->failcount != rhs->failcount)
-			return lhs->failcount < rhs->failcount;
-
-		// Local peers should always be tried first
-		bool const lhs_local = aux::is_local(lhs->address());
-		bool const rhs_local = aux::is_local(rhs->address());
-		if (lhs_local != rhs_local) return int(lhs_local) > int(rhs_local);
-
-		if (lhs->last_connected != rhs->last_connected)
-			return lhs->last_connected < rhs->last_connected;
-
-		if (finished && lhs->maybe_upload_only != rhs->maybe_upload_only)
-		{
-			// if we're finished, de-prioritze peers we think may be seeds
-			// since being upload-only doesn't necessarily mean it's a good peer
-			// to be connected to as a downloader, we don't prioritize the
-			// inverse when we're not finished
-			return rhs->maybe_upload_only;
-		}
+		std::uint64_t ret = 31 - p.failcount;
+		ret <<= 1;
+		ret |= aux::is_local(p.address()) ? 1 : 0;
+		ret <<= 16;
+		ret |= 0xffffu - p.last_connected;
+		ret <<= 1;
+		ret |= (finished && !p.maybe_upload_only) ? 1 : 0;
+		ret <<= 6;
+		ret |= std::uint64_t(aux::source_rank(p.peer_source()) & 0x3f);
+		ret <<= 32;
+		ret |= p.rank(external, external_port);
+		return ret;
+	}
 
-		int const lhs_rank = aux::source_rank(lhs->peer_source());
-		int const rhs_rank = aux::source_rank(rhs->peer_source());
-		if (lhs_rank != rhs_rank) return lhs_rank > rhs_rank;
+	std::uint16_t clamped_subtract_u16(int const a, int const b)
+	{
+		if (a < b) return 0;
+		return std::uint16_t(a - b);
+	}
 
-		std::uint32_t const lhs_peer_rank = lhs->rank(external, external_port);
-		std::uint32_t const rhs_peer_rank = rhs->rank(external, external_port);
-		return lhs_peer_rank > rhs_peer_rank;
+	// the session time at which p may be connected to again
+	int retry_time(aux::torrent_peer const& p, int const min_reconnect_time)
+	{
+		if (p.last_connected == 0) return 0;
+		return int(p.last_connected) + (int(p.failcount) + 1) * min_reconnect_time;
 	}
 
 } // anonymous namespace
@@ -136,7 +135,8 @@ namespace libtorrent::aux {
 		for (auto* p : m_peers)
 			m_peer_allocator.free_peer_entry(p);
 		m_peers.clear();
-		m_candidate_cache.clear();
+		m_ready.clear();
+		m_waiting.clear();
 		m_num_connect_candidates = 0;
 		m_num_seeds = 0;
 	}
@@ -215,6 +215,63 @@ namespace libtorrent::aux {
 		INVARIANT_CHECK;
 		for (auto& p : m_peers)
 			p->peer_rank = 0;
+
+		// the priorities in the ready queue depend on the peer ranks. Move
+		// them all back to the waiting queue, as immediately due, to have
+		// them re-ranked the next time we connect to a peer
+		for (auto const& e : m_ready)
+			m_waiting.push_back({e.peer, 0});
+		m_ready.clear();
+		std::make_heap(m_waiting.begin(), m_waiting.end(), std::greater<>());
+	}
+
+	void peer_list::step_session_time(int const seconds)
+	{
+		INVARIANT_CHECK;
+		for (auto* pe : m_peers)
+		{
+			pe->last_optimistically_unchoked
+				= clamped_subtract_u16(pe->last_optimistically_unchoked, seconds);
+			pe->last_connected = clamped_subtract_u16(pe->last_connected, seconds);
+		}
+
+		// the retry times are session times too
+		for (auto& e : m_waiting)
+		{
+			if (e.peer == nullptr) continue;
+			e.key = std::uint64_t(retry_time(*e.peer, m_min_reconnect_time));
+		}
+		std::make_heap(m_waiting.begin(), m_waiting.end(), std::greater<>());
+	}
+
+	void peer_list::clear_last_connected()
+	{
+		INVARIANT_CHECK;
+		for (auto* pe : m_peers)
+			pe->last_connected = 0;
+
+		// every peer in the queue may be connected to immediately now
+		for (auto& e : m_waiting)
+			e.key = 0;
+	}
+
+	void peer_list::queue_connect_candidate(torrent_peer* p)
+	{
+		TORRENT_ASSERT(!p->in_connect_queue);
+		p->in_connect_queue = true;
+		push_waiting(p, retry_time(*p, m_min_reconnect_time));
+	}
+
+	void peer_list::push_waiting(torrent_peer* p, int const retry)
+	{
+		m_waiting.push_back({p, std::uint64_t(std::max(retry, 0))});
+		std::push_heap(m_waiting.begin(), m_waiting.end(), std::greater<>());
+	}
+
+	void peer_list::push_ready(torrent_peer* p, std::uint64_t const prio)
+	{
+		m_ready.push_back({p, prio});
+		std::push_heap(m_ready.begin(), m_ready.end());
 	}
 
 	// disconnects and removes all peers that are now filtered
@@ -304,15 +361,21 @@ namespace libtorrent::aux {
 			--m_num_seeds;
 		}
 		if (is_connect_candidate(**i))
-			update_connect_candidates(-1);
+			update_connect_candidates(*i, -1);
 		TORRENT_ASSERT(m_num_connect_candidates < int(m_peers.size()));
-		if (m_round_robin > i - m_peers.begin()) --m_round_robin;
-		if (m_round_robin >= int(m_peers.size())) m_round_robin = 0;
 
-		// if this peer is in the connect candidate
-		// cache, erase it from there as well
-		auto const ci = std::find(m_candidate_cache.begin(), m_candidate_cache.end(), *i);
-		if (ci != m_candidate_cache.end()) m_candidate_cache.erase(ci);
+		// if this peer is in the connect queue, clear its entry. It's left in
+		// the heap (to not have to restore the heap property) and skipped
+		// once it's popped
+		if ((*i)->in_connect_queue)
+		{
+			for (auto* q : {&m_ready, &m_waiting})
+			{
+				auto const ci = std::find_if(q->begin(), q->end()
+					, [&](connect_entry const& e) { return e.peer == *i; });
+				if (ci != q->end()) ci->peer = nullptr;
+			}
+		}
 
 		m_peer_allocator.free_peer_entry(*i);
 		m_peers.erase(i);
@@ -426,7 +489,7 @@ namespace libtorrent::aux {
 		TORRENT_ASSERT(p->in_use);
 
 		if (is_connect_candidate(*p))
-			update_connect_candidates(-1);
+			update_connect_candidates(p, -1);
 
 		p->banned = true;
 		TORRENT_ASSERT(!is_connect_candidate(*p));
@@ -446,7 +509,7 @@ namespace libtorrent::aux {
 		// now that we're connected, no need to assume the peer is a seed
 		// anymore. We'll soon know.
 		p->maybe_upload_only = false;
-		if (was_conn_cand) update_connect_candidates(-1);
+		if (was_conn_cand) update_connect_candidates(p, -1);
 	}
 
 	void peer_list::inc_failcount(torrent_peer* p)
@@ -458,7 +521,7 @@ namespace libtorrent::aux {
 		bool const was_conn_cand = is_connect_candidate(*p);
 		++p->failcount;
 		if (was_conn_cand && !is_connect_candidate(*p))
-			update_connect_candidates(-1);
+			update_connect_candidates(p, -1);
 	}
 
 	void peer_list::set_failcount(torrent_peer* p, int const f)
@@ -471,7 +534,7 @@ namespace libtorrent::aux {
 		p->failcount = aux::numeric_cast<std::uint32_t>(f);
 		if (was_conn_cand != is_connect_candidate(*p))
 		{
-			update_connect_candidates(was_conn_cand ? -1 : 1);
+			update_connect_candidates(p, was_conn_cand ? -1 : 1);
 		}
 	}
 
@@ -491,96 +554,6 @@ namespace libtorrent::aux {
 		return true;
 	}
 
-	void peer_list::find_connect_candidates(std::vector<torrent_peer*>& peers
-		, int session_time, torrent_state* state)
-	{
-		TORRENT_ASSERT(is_single_thread());
-		INVARIANT_CHECK;
-
-		const int candidate_count = 10;
-		peers.reserve(candidate_count);
-
-		int erase_candidate = -1;
-
-		if (bool(m_finished) != state->is_finished)
-			recalculate_connect_candidates(state);
-
-		aux::external_ip const& external = state->ip;
-		int external_port = state->port;
-
-		if (m_round_robin >= int(m_peers.size())) m_round_robin = 0;
-
-		int max_peerlist_size = state->max_peerlist_size;
-
-		// TODO: 2 it would be nice if there was a way to iterate over these
-		// torrent_peer objects in the order they are allocated in the pool
-		// instead. It would probably be more efficient
-		for (int iterations = std::min(int(m_peers.size()), 300);
-			iterations > 0; --iterations)
-		{
-			++state->loop_counter;
-
-			if (m_round_robin >= int(m_peers.size())) m_round_robin = 0;
-
-			torrent_peer& pe = *m_peers[m_round_robin];
-			TORRENT_ASSERT(pe.in_use);
-			int current = m_round_robin;
-
-			// if the number of peers is growing large
-			// we need to start weeding.
-
-			if (int(m_peers.size()) >= max_peerlist_size * 0.95
-				&& max_peerlist_size > 0)
-			{
-				if (is_erase_candidate(pe)
-					&& (erase_candidate == -1
-						|| !compare_peer_erase(*m_peers[erase_candidate], pe)))
-				{
-					if (should_erase_immediately(pe))
-					{
-						if (erase_candidate > current) --erase_candidate;
-						erase_peer(m_peers.begin() + current, state);
-						continue;
-					}
-					else
-					{
-						erase_candidate = current;
-					}
-				}
-			}
-
-			++m_round_robin;
-
-			if (!is_connect_candidate(pe)) continue;
-
-			if (pe.last_connected
-				&& session_time - pe.last_connected <
-				(int(pe.failcount) + 1) * state->min_reconnect_time)
-				continue;
-
-			// compare peer returns true if lhs is better than rhs. In this
-			// case, it returns true if the current candidate is better than
-			// pe, which is the peer m_round_robin points to. If it is, just
-			// keep looking.
-			if (peers.size() == candidate_count
-				&& compare_peer(peers.back(), &pe, external, external_port, m_finished)) continue;
-
-			if (peers.size() >= candidate_count)
-				peers.resize(candidate_count - 1);
-
-			// insert this candidate sorted into peers
-			auto const i = std::lower_bound(peers.begin(), peers.end()
-				, &pe, std::bind(&compare_peer, _1, _2, std::cref(external), external_port, bool(m_finished)));
-
-			peers.insert(i, &pe);
-		}
-
-		if (erase_candidate > -1)
-		{
-			erase_peer(m_peers.begin() + erase_candidate, state);
-		}
-	}
-
 	bool peer_list::new_connection(peer_connection_interface& c, int session_time
 		, torrent_state* state)
 	{
@@ -804,7 +777,7 @@ namespace libtorrent::aux {
 			}
 
 			if (is_connect_candidate(*i))
-				update_connect_candidates(-1);
+				update_connect_candidates(i, -1);
 		}
 		else
 		{
@@ -834,7 +807,7 @@ namespace libtorrent::aux {
 				i = add_i2p_peer(i2p_dest, peer_info::incoming, {}, state);
 				// we're about to attach the new connection to this torrent_peer
 				if (is_connect_candidate(*i))
-					update_connect_candidates(-1);
+					update_connect_candidates(i, -1);
 			}
 			else
 #endif
@@ -852,8 +825,6 @@ namespace libtorrent::aux {
 
 				iter = m_peers.insert(iter, p);
 
-				if (m_round_robin >= iter - m_peers.begin()) ++m_round_robin;
-
 				i = *iter;
 
 				i->source = static_cast<std::uint8_t>(peer_info::incoming);
@@ -912,7 +883,7 @@ namespace libtorrent::aux {
 					pp.connectable = true;
 					pp.source |= static_cast<std::uint8_t>(src);
 					if (!was_conn_cand && is_connect_candidate(pp))
-						update_connect_candidates(1);
+						update_connect_candidates(&pp, 1);
 					// calling disconnect() on a peer, may actually end
 					// up "garbage collecting" its torrent_peer entry
 					// as well, if it's considered useless (which this specific)
@@ -943,7 +914,7 @@ namespace libtorrent::aux {
 		p->connectable = true;
 
 		if (was_conn_cand != is_connect_candidate(*p))
-			update_connect_candidates(was_conn_cand ? -1 : 1);
+			update_connect_candidates(p, was_conn_cand ? -1 : 1);
 		return true;
 	}
 
@@ -966,7 +937,7 @@ namespace libtorrent::aux {
 		bool const was_conn_cand = is_connect_candidate(*p);
 		p->seed = s;
 		if (was_conn_cand && !is_connect_candidate(*p))
-			update_connect_candidates(-1);
+			update_connect_candidates(p, -1);
 
 		if (p->web_seed) return;
 		if (s)
@@ -991,9 +962,9 @@ namespace libtorrent::aux {
 		p->upload_only = s;
 		bool const is_conn_cand = is_connect_candidate(*p);
 		if (was_conn_cand && !is_conn_cand)
-			update_connect_candidates(-1);
+			update_connect_candidates(p, -1);
 		else if (!was_conn_cand && is_conn_cand)
-			update_connect_candidates(1);
+			update_connect_candidates(p, 1);
 		// unlike set_seed, do NOT touch m_num_seeds: a BEP-21 upload_only
 		// peer is not necessarily a full seed (partial seeds qualify too).
 	}
@@ -1036,8 +1007,6 @@ namespace libtorrent::aux {
 
 		iter = m_peers.insert(iter, p);
 
-		if (m_round_robin >= iter - m_peers.begin()) ++m_round_robin;
-
 #if !defined TORRENT_DISABLE_ENCRYPTION
 		if (flags & pex_encryption) p->pe_support = true;
 #endif
@@ -1050,7 +1019,7 @@ namespace libtorrent::aux {
 		if (flags & pex_lt_v2)
 			p->protocol_v2 = true;
 		if (is_connect_candidate(*p))
-			update_connect_candidates(1);
+			update_connect_candidates(p, 1);
 
 		return true;
 	}
@@ -1099,14 +1068,20 @@ namespace libtorrent::aux {
 
 		if (was_conn_cand != is_connect_candidate(*p))
 		{
-			update_connect_candidates(was_conn_cand ? -1 : 1);
+			update_connect_candidates(p, was_conn_cand ? -1 : 1);
 		}
 	}
 
-	void peer_list::update_connect_candidates(int delta)
+	void peer_list::update_connect_candidates(torrent_peer* p, int delta)
 	{
 		TORRENT_ASSERT(is_single_thread());
 		if (delta == 0) return;
+
+		// a peer that's already in the queue may have a stale entry, but
+		// that's fixed up when it's popped
+		if (delta > 0 && !p->in_connect_queue)
+			queue_connect_candidate(p);
+
 		m_num_connect_candidates += delta;
 		if (delta < 0)
 		{
@@ -1275,27 +1250,89 @@ namespace libtorrent::aux {
 		TORRENT_ASSERT(is_single_thread());
 		INVARIANT_CHECK;
 
-		if (bool(m_finished) != state->is_finished)
+		if (bool(m_finished) != state->is_finished
+			|| m_min_reconnect_time != state->min_reconnect_time)
 			recalculate_connect_candidates(state);
 
-		// clear out any peers from the cache that no longer
-		// are connection candidates
-		for (auto i = m_candidate_cache.begin(); i != m_candidate_cache.end();)
+		// if the number of peers is growing large
+		// we need to start weeding.
+		int const max_peerlist_size = state->max_peerlist_size;
+		if (max_peerlist_size > 0
+			&& int(m_peers.size()) >= max_peerlist_size * 0.95)
 		{
-			if (!is_connect_candidate(**i))
-				i = m_candidate_cache.erase(i);
-			else
-				++i;
+			erase_peers(state);
 		}
 
-		if (m_candidate_cache.empty())
+		// move the peers whose retry time has passed over to the ready queue.
+		// Entries are checked lazily, as they're popped. A peer may have been
+		// erased, stopped being a connect candidate or had its retry time
+		// pushed back since it was queued
+		while (!m_waiting.empty() && m_waiting.front().key <= std::uint64_t(std::max(session_time, 0)))
 		{
-			find_connect_candidates(m_candidate_cache, session_time, state);
-			if (m_candidate_cache.empty()) return nullptr;
+			++state->loop_counter;
+			std::pop_heap(m_waiting.begin(), m_waiting.end(), std::greater<>());
+			torrent_peer* pe = m_waiting.back().peer;
+			m_waiting.pop_back();
+			if (pe == nullptr) continue;
+
+			TORRENT_ASSERT(pe->in_use);
+			TORRENT_ASSERT(pe->in_connect_queue);
+			if (!is_connect_candidate(*pe))
+			{
+				pe->in_connect_queue = false;
+				continue;
+			}
+
+			int const t = retry_time(*pe, m_min_reconnect_time);
+			if (t > session_time)
+			{
+				push_waiting(pe, t);
+				continue;
+			}
+			push_ready(pe, connect_priority(*pe, state->ip, state->port, m_finished));
 		}
 
-		torrent_peer* p = m_candidate_cache.front();
-		m_candidate_cache.erase(m_candidate_cache.begin());
+		torrent_peer* p = nullptr;
+		while (!m_ready.empty())
+		{
+			++state->loop_counter;
+			std::pop_heap(m_ready.begin(), m_ready.end());
+			connect_entry const e = m_ready.back();
+			m_ready.pop_back();
+			if (e.peer == nullptr) continue;
+
+			TORRENT_ASSERT(e.peer->in_use);
+			TORRENT_ASSERT(e.peer->in_connect_queue);
+			if (!is_connect_candidate(*e.peer))
+			{
+				e.peer->in_connect_queue = false;
+				continue;
+			}
+
+			int const t = retry_time(*e.peer, m_min_reconnect_time);
+			if (t > session_time)
+			{
+				push_waiting(e.peer, t);
+				continue;
+			}
+
+			// if the peer's priority has changed since it was queued, put it
+			// back in its right place
+			std::uint64_t const prio = connect_priority(*e.peer, state->ip, state->port, m_finished);
+			if (prio != e.key)
+			{
+				push_ready(e.peer, prio);
+				continue;
+			}
+
+			// the peer stays queued. Once we connect to it, it's no longer a
+			// connect candidate and it's dropped the next time it's popped. If
+			// it fails, it's picked up again after its retry time
+			push_waiting(e.peer, t);
+			p = e.peer;
+			break;
+		}
+		if (p == nullptr) return nullptr;
 
 		TORRENT_ASSERT(p->in_use);
 		TORRENT_ASSERT(!p->banned);
@@ -1305,7 +1342,8 @@ namespace libtorrent::aux {
 		TORRENT_ASSERT(!p->is_rtc_addr);
 #endif
 
-		// this should hold because find_connect_candidates should have done this
+		// this should hold because recalculate_connect_candidates() is called
+		// above if it's not
 		TORRENT_ASSERT(bool(m_finished) == state->is_finished);
 
 		// if we're finished, p->seed must be 0. We shouldn't be connecting to
@@ -1361,7 +1399,7 @@ namespace libtorrent::aux {
 		}
 
 		if (is_connect_candidate(*p))
-			update_connect_candidates(1);
+			update_connect_candidates(p, 1);
 
 		// if we're already a seed, it's not as important
 		// to keep all the possibly stale peers
@@ -1396,9 +1434,21 @@ namespace libtorrent::aux {
 		m_num_connect_candidates = 0;
 		m_finished = state->is_finished;
 		m_max_failcount = state->max_failcount;
+		m_min_reconnect_time = state->min_reconnect_time;
 
-		m_num_connect_candidates += static_cast<int>(std::count_if(m_peers.begin(), m_peers.end()
-			, [this](torrent_peer const* p) { return this->is_connect_candidate(*p); } ));
+		// the set of connect candidates, and their retry times, may have
+		// changed. Rebuild the queue from scratch
+		m_ready.clear();
+		m_waiting.clear();
+		for (auto* p : m_peers)
+		{
+			p->in_connect_queue = false;
+			if (!is_connect_candidate(*p)) continue;
+			++m_num_connect_candidates;
+			p->in_connect_queue = true;
+			m_waiting.push_back({p, std::uint64_t(retry_time(*p, m_min_reconnect_time))});
+		}
+		std::make_heap(m_waiting.begin(), m_waiting.end(), std::greater<>());
 
 #if TORRENT_USE_INVARIANT_CHECKS
 		// the invariant is not likely to be upheld at the entry of this function
@@ -1437,6 +1487,7 @@ namespace libtorrent::aux {
 		TORRENT_ASSERT(is_single_thread());
 		TORRENT_ASSERT(m_num_connect_candidates >= 0);
 		TORRENT_ASSERT(m_num_connect_candidates <= int(m_peers.size()));
+		TORRENT_ASSERT(m_ready.size() + m_waiting.size() >= std::size_t(m_num_connect_candidates));
 
 #ifdef TORRENT_EXPENSIVE_INVARIANT_CHECKS
 		int connect_candidates = 0;
@@ -1452,7 +1503,10 @@ namespace libtorrent::aux {
 			}
 			torrent_peer const& p = **i;
 			TORRENT_ASSERT(p.in_use);
-			if (is_connect_candidate(p)) ++connect_candidates;
+			bool const candidate = is_connect_candidate(p);
+			// every connect candidate must be in the connect queue
+			TORRENT_ASSERT(!candidate || p.in_connect_queue);
+			if (candidate) ++connect_candidates;
 			if (!p.connection)
 			{
 				continue;
@@ -10,10 +10,26 @@ see LICENSE file.
 
 #include "libtorrent/performance_counters.hpp"
 #include "libtorrent/assert.hpp"
+#include "libtorrent/aux_/ffs.hpp" // for leading_zeros
 #include <cstring> // for memset
+#include <algorithm> // for min
 
 namespace libtorrent {
 
+#ifdef ATOMIC_LLONG_LOCK_FREE
+namespace {
+
+	// the shard the calling thread increments counters in
+	int thread_shard(int const num_shards) noexcept
+	{
+		static std::atomic<unsigned int> next_shard{0};
+		thread_local unsigned int const shard
+			= next_shard.fetch_add(1, std::memory_order_relaxed);
+		return int(shard % unsigned(num_shards));
+	}
+}
+#endif
+
 	// TODO: move stats_counter_t out of counters
 	// TODO: should bittorrent keep-alive messages have a counter too?
 	// TODO: It would be nice if this could be an internal type. default_disk_constructor depends on it now
@@ -22,6 +38,9 @@ namespace libtorrent {
 #ifdef ATOMIC_LLONG_LOCK_FREE
 		for (auto& counter : m_stats_counter)
 			counter.store(0, std::memory_order_relaxed);
+		for (auto& shard : m_shards)
+			for (auto& counter : shard.counter)
+				counter.store(0, std::memory_order_relaxed);
 #else
 		m_stats_counter.fill(0);
 #endif
@@ -30,10 +49,12 @@ namespace libtorrent {
 	counters::counters(counters const& c) TORRENT_COUNTER_NOEXCEPT
 	{
 #ifdef ATOMIC_LLONG_LOCK_FREE
+		// the shards of the copy are folded into its base values
 		for (int i = 0; i < m_stats_counter.end_index(); ++i)
-			m_stats_counter[i].store(
-				c.m_stats_counter[i].load(std::memory_order_relaxed)
-					, std::memory_order_relaxed);
+			m_stats_counter[i].store(c[i], std::memory_order_relaxed);
+		for (auto& shard : m_shards)
+			for (auto& counter : shard.counter)
+				counter.store(0, std::memory_order_relaxed);
 #else
 		std::lock_guard<std::mutex> l(c.m_mutex);
 		m_stats_counter = c.m_stats_counter;
@@ -44,10 +65,12 @@ namespace libtorrent {
 	{
 		if (&c == this) return *this;
 #ifdef ATOMIC_LLONG_LOCK_FREE
+		// the shards of the copy are folded into its base values
 		for (int i = 0; i < m_stats_counter.end_index(); ++i)
-			m_stats_counter[i].store(
-				c.m_stats_counter[i].load(std::memory_order_relaxed)
-					, std::memory_order_relaxed);
+			m_stats_counter[i].store(c[i], std::memory_order_relaxed);
+		for (auto& shard : m_shards)
+			for (auto& counter : shard.counter)
+				counter.store(0, std::memory_order_relaxed);
 #else
 		std::lock_guard<std::mutex> l(m_mutex);
 		std::lock_guard<std::mutex> l2(c.m_mutex);
@@ -62,7 +85,8 @@ namespace libtorrent {
 		TORRENT_ASSERT(i < num_counters);
 
 #ifdef ATOMIC_LLONG_LOCK_FREE
-		return m_stats_counter[i].load(std::memory_order_relaxed);
+		std::int64_t const base = m_stats_counter[i].load(std::memory_order_relaxed);
+		return i < num_stats_counters ? base + sum_shards(i) : base;
 #else
 		std::lock_guard<std::mutex> l(m_mutex);
 		return m_stats_counter[i];
@@ -81,6 +105,14 @@ namespace libtorrent {
 		TORRENT_ASSERT(c < num_counters);
 
 #ifdef ATOMIC_LLONG_LOCK_FREE
+		if (c < num_stats_counters)
+		{
+			// only the calling thread increments its shard (unless more
+			// threads than shards are incrementing), so the cache line is
+			// unlikely to be shared
+			auto& counter = m_shards[thread_shard(num_counter_shards)].counter[c];
+			return counter.fetch_add(value, std::memory_order_relaxed) + value;
+		}
 		std::int64_t pv = m_stats_counter[c].fetch_add(value, std::memory_order_relaxed);
 		TORRENT_ASSERT(pv + value >= 0);
 		return pv + value;
@@ -116,12 +148,34 @@ namespace libtorrent {
 #endif
 	}
 
+	void counters::add_histogram_sample(int const h, std::int64_t const value) TORRENT_COUNTER_NOEXCEPT
+	{
+		TORRENT_ASSERT(h >= disk_job_queue_time_hist);
+		TORRENT_ASSERT(h + num_histogram_buckets <= num_stats_counters);
+		TORRENT_ASSERT((h - disk_job_queue_time_hist) % num_histogram_buckets == 0);
+
+		// bucket n holds the values whose most significant set bit is bit
+		// n - 1
+		auto const v = static_cast<std::uint32_t>(std::min(std::max(value
+			, std::int64_t(0)), std::int64_t(0xffffffff)));
+		int const bucket = v == 0 ? 0
+			: std::min(32 - aux::leading_zeros(v), num_histogram_buckets - 1);
+		inc_stats_counter(h + bucket);
+	}
+
 	void counters::set_value(int const c, std::int64_t const value) TORRENT_COUNTER_NOEXCEPT
 	{
 		TORRENT_ASSERT(c >= 0);
 		TORRENT_ASSERT(c < num_counters);
 
 #ifdef ATOMIC_LLONG_LOCK_FREE
+		if (c < num_stats_counters)
+		{
+			// increments made to the shards after they're summed here are
+			// added on top of value, as if they were made after this call
+			m_stats_counter[c].store(value - sum_shards(c));
+			return;
+		}
 		m_stats_counter[c].store(value);
 #else
 		std::lock_guard<std::mutex> l(m_mutex);
@@ -134,4 +188,16 @@ namespace libtorrent {
 #endif
 	}
 
+#ifdef ATOMIC_LLONG_LOCK_FREE
+	std::int64_t counters::sum_shards(int const c) const noexcept
+	{
+		TORRENT_ASSERT(c >= 0);
+		TORRENT_ASSERT(c < num_stats_counters);
+		std::int64_t ret = 0;
+		for (auto const& shard : m_shards)
+			ret += shard.counter[c].load(std::memory_order_relaxed);
+		return ret;
+	}
+#endif
+
 }
@@ -21,6 +21,7 @@ see LICENSE file.
 #include <limits>
 #include <functional>
 #include <tuple>
+#include <cstring> // for memcpy
 
 #include "libtorrent/aux_/piece_picker.hpp"
 #include "libtorrent/bitfield.hpp"
@@ -252,6 +253,7 @@ namespace libtorrent::aux {
 		// always insert into bucket 0 (piece_downloading)
 		downloading_piece ret;
 		ret.index = piece;
+		ret.download_start = clock_type::now();
 		auto const download_state = piece_pos::piece_downloading;
 		auto downloading_iter = std::lower_bound(m_downloads[download_state].begin()
 			, m_downloads[download_state].end(), ret);
@@ -785,6 +787,18 @@ namespace libtorrent::aux {
 		return std::make_pair(min_availability + m_seeds, fraction_part * 1000 / npieces);
 	}
 
+	std::pair<int, int> distributed_copies(span<int const> const availability)
+	{
+		auto const npieces = int(availability.size());
+		if (npieces == 0) return std::make_pair(1, 0);
+
+		int const min_availability = *std::min_element(availability.begin()
+			, availability.end());
+		auto const fraction_part = int(std::count_if(availability.begin()
+			, availability.end(), [=](int const a) { return a > min_availability; }));
+		return std::make_pair(min_availability, fraction_part * 1000 / npieces);
+	}
+
 	prio_index_t piece_picker::priority_begin(int const prio) const
 	{
 		TORRENT_ASSERT(prio >= 0);
@@ -1208,6 +1222,21 @@ namespace libtorrent::aux {
 		m_dirty = true;
 	}
 
+	void piece_picker::inc_uncounted_peer()
+	{
+		++m_uncounted_peers;
+		// when the first uncounted peer joins, pieces without any counted
+		// peers become pickable
+		if (m_uncounted_peers == 1) m_dirty = true;
+	}
+
+	void piece_picker::dec_uncounted_peer()
+	{
+		TORRENT_ASSERT(m_uncounted_peers > 0);
+		--m_uncounted_peers;
+		if (m_uncounted_peers == 0) m_dirty = true;
+	}
+
 	void piece_picker::inc_refcount(piece_index_t const index
 		, const aux::torrent_peer* peer)
 	{
@@ -1328,15 +1357,13 @@ namespace libtorrent::aux {
 			// and mark the picker as dirty, so we'll rebuild it next time we need it.
 			// this only matters if we're not already dirty, in which case the fasted
 			// thing to do is to just update the counters and be done
-			piece_index_t index{0};
 			int num_inc = 0;
-			for (auto i = bitmask.begin(), end(bitmask.end()); i != end; ++i, ++index)
+			bitmask.for_each_set_bit([&](piece_index_t const index)
 			{
-				if (!*i) continue;
 				if (num_inc < size) incremented[num_inc] = index;
 				++num_inc;
-				if (num_inc >= size) break;
-			}
+				return num_inc >= size;
+			});
 
 			if (num_inc < size)
 			{
@@ -1364,23 +1391,20 @@ namespace libtorrent::aux {
 			}
 		}
 
-		piece_index_t index{0};
 		bool updated = false;
-		for (auto i = bitmask.begin(), end(bitmask.end()); i != end; ++i, ++index)
+		bitmask.for_each_set_bit([&](piece_index_t const index)
 		{
-			if (*i)
-			{
 #ifdef TORRENT_DEBUG_REFCOUNTS
-				TORRENT_ASSERT(m_piece_map[index].have_peers.count(peer) == 0);
-				m_piece_map[index].have_peers.insert(peer);
+			TORRENT_ASSERT(m_piece_map[index].have_peers.count(peer) == 0);
+			m_piece_map[index].have_peers.insert(peer);
 #else
-				TORRENT_UNUSED(peer);
+			TORRENT_UNUSED(peer);
 #endif
 
-				++m_piece_map[index].peer_count;
-				updated = true;
-			}
-		}
+			++m_piece_map[index].peer_count;
+			updated = true;
+			return false;
+		});
 
 		// if we're already dirty, no point in doing anything more
 		if (m_dirty) return;
@@ -1424,15 +1448,13 @@ namespace libtorrent::aux {
 			// and mark the picker as dirty, so we'll rebuild it next time we need it.
 			// this only matters if we're not already dirty, in which case the fasted
 			// thing to do is to just update the counters and be done
-			piece_index_t index{0};
 			int num_dec = 0;
-			for (auto i = bitmask.begin(), end(bitmask.end()); i != end; ++i, ++index)
+			bitmask.for_each_set_bit([&](piece_index_t const index)
 			{
-				if (!*i) continue;
 				if (num_dec < size) decremented[num_dec] = index;
 				++num_dec;
-				if (num_dec >= size) break;
-			}
+				return num_dec >= size;
+			});
 
 			if (num_dec < size)
 			{
@@ -1469,35 +1491,32 @@ namespace libtorrent::aux {
 			}
 		}
 
-		piece_index_t index{0};
 		bool updated = false;
-		for (auto i = bitmask.begin(), end(bitmask.end()); i != end; ++i, ++index)
+		bitmask.for_each_set_bit([&](piece_index_t const index)
 		{
-			if (*i)
+			piece_pos& p = m_piece_map[index];
+			if (p.peer_count == 0)
 			{
-				piece_pos& p = m_piece_map[index];
-				if (p.peer_count == 0)
-				{
-					TORRENT_ASSERT(m_seeds > 0);
-					// this is the case where we have one or more
-					// seeds, and one of them saying: I don't have this
-					// piece anymore. we need to break up one of the seed
-					// counters into actual peer counters on the pieces
-					break_one_seed();
-				}
+				TORRENT_ASSERT(m_seeds > 0);
+				// this is the case where we have one or more
+				// seeds, and one of them saying: I don't have this
+				// piece anymore. we need to break up one of the seed
+				// counters into actual peer counters on the pieces
+				break_one_seed();
+			}
 
 #ifdef TORRENT_DEBUG_REFCOUNTS
-				TORRENT_ASSERT(p.have_peers.count(peer) == 1);
-				p.have_peers.erase(peer);
+			TORRENT_ASSERT(p.have_peers.count(peer) == 1);
+			p.have_peers.erase(peer);
 #else
-				TORRENT_UNUSED(peer);
+			TORRENT_UNUSED(peer);
 #endif
 
-				TORRENT_ASSERT(p.peer_count > 0);
-				--p.peer_count;
-				updated = true;
-			}
-		}
+			TORRENT_ASSERT(p.peer_count > 0);
+			--p.peer_count;
+			updated = true;
+			return false;
+		});
 
 		// if we're already dirty, no point in doing anything more
 		if (m_dirty) return;
@@ -2228,7 +2247,38 @@ namespace {
 					if (to_erase != -1) m_recent_extents.erase(m_recent_extents.begin() + to_erase);
 				}
 
-				for (piece_index_t i : m_pieces)
+				// when the peer only has a small fraction of the pieces we
+				// want, walking its bitfield is a lot cheaper than testing every
+				// entry in m_pieces against it. Visiting its pieces ordered by
+				// their position in m_pieces picks them in the same order as
+				// the full scan would
+				int const max_candidates = (options & sequential) ? 0
+					: std::min(int(m_pieces.size()) / 16, 1024);
+				TORRENT_ALLOCA(candidates, prio_index_t, max_candidates);
+				int const num_candidates = max_candidates > 0
+					? sparse_pick_candidates(pieces, candidates) : -1;
+
+				if (num_candidates >= 0)
+				{
+					std::sort(candidates.begin(), candidates.begin() + num_candidates);
+					for (int c = 0; c < num_candidates; ++c)
+					{
+						pc.inc_stats_counter(counters::piece_picker_rare_loops);
+
+						piece_index_t const i = m_pieces[candidates[c]];
+						if (!is_piece_free(i, pieces)) continue;
+
+						ret |= picker_log_alert::rarest_first;
+
+						num_blocks = add_blocks(i, pieces
+							, interesting_blocks
+							, backup_blocks, num_blocks
+							, prefer_contiguous_blocks, peer, ignored_pieces
+							, options);
+						if (num_blocks <= 0) return ret;
+					}
+				}
+				else for (piece_index_t i : m_pieces)
 				{
 					pc.inc_stats_counter(counters::piece_picker_rare_loops);
 
@@ -2539,6 +2589,43 @@ get_out:
 			&& !m_piece_map[piece].filtered();
 	}
 
+	int piece_picker::sparse_pick_candidates(typed_bitfield<piece_index_t> const& bitmask
+		, span<prio_index_t> const candidates) const
+	{
+		TORRENT_ASSERT(!m_dirty);
+		int num_candidates = 0;
+		char const* const bits = bitmask.data();
+		int const num_words = bitmask.num_words();
+		for (int w = 0; w < num_words; ++w)
+		{
+			// skip 32 pieces at a time the peer doesn't have
+			std::uint32_t word;
+			std::memcpy(&word, bits + w * 4, 4);
+			if (word == 0) continue;
+
+			piece_index_t const end(std::min((w + 1) * 32, bitmask.size()));
+			for (piece_index_t i(w * 32); i < end; ++i)
+			{
+				if (!bitmask[i]) continue;
+				piece_pos const& pp = m_piece_map[i];
+				// pieces with a negative priority are not in m_pieces
+				if (pp.priority(this) < 0) continue;
+				if (num_candidates == candidates.size()) return -1;
+				TORRENT_ASSERT(m_pieces[pp.index] == i);
+				candidates[num_candidates++] = pp.index;
+			}
+
+			// if the pieces seen so far suggest the peer has a lot more
+			// pieces than fit, give up early rather than scanning the
+			// whole bitfield only to fall back to walking m_pieces anyway
+			if (num_candidates > candidates.size() / 32
+				&& std::int64_t(num_candidates) * num_words
+				> std::int64_t(candidates.size()) * 2 * (w + 1))
+				return -1;
+		}
+		return num_candidates;
+	}
+
 	bool piece_picker::can_pick(piece_index_t const piece
 		, typed_bitfield<piece_index_t> const& bitmask) const
 	{
@@ -3762,6 +3849,15 @@ get_out:
 		return d;
 	}
 
+	time_point piece_picker::download_start(piece_index_t const index) const
+	{
+		auto const state = m_piece_map[index].download_queue();
+		if (state == piece_pos::piece_open) return {};
+		auto const i = find_dl_piece(state, index);
+		TORRENT_ASSERT(i != m_downloads[state].end());
+		return i->download_start;
+	}
+
 	aux::torrent_peer* piece_picker::get_downloader(piece_block const block) const
 	{
 		auto const state = m_piece_map[block.piece_index].download_queue();
@@ -481,10 +481,20 @@ void pread_disk_io::perform_job(aux::pread_disk_job* j, jobqueue_t& completed_jo
 	});
 
 
+	time_point const start_time = clock_type::now();
+	if (j->start_time != time_point{})
+	{
+		m_stats_counters.add_histogram_sample(counters::disk_job_queue_time_hist
+			, total_microseconds(start_time - j->start_time));
+	}
+
 	status_t const ret = translate_error(j, [&] {
 		return std::visit([this, j](auto& a) { return this->do_job(a, j); }, j->action);
 	});
 
+	m_stats_counters.add_histogram_sample(counters::disk_job_exec_time_hist
+		, total_microseconds(clock_type::now() - start_time));
+
 	if (ret & disk_status::job_deferred) return;
 
 	j->ret = ret;
@@ -1618,12 +1628,12 @@ void pread_disk_io::add_job(aux::pread_disk_job* j, bool const user_add)
 	TORRENT_ASSERT(!j->storage || j->storage->files().is_valid());
 	TORRENT_ASSERT(j->next == nullptr);
 
-#if TORRENT_DISK_LATENCY_STATS
-	// stamp the job on the network thread, where add_job runs. The matching
-	// measurement happens when the completion handler runs (also on the
-	// network thread), so the latency includes both disk queues.
+	// stamp the job on the network thread, where add_job runs. The queue time
+	// is measured when the job starts executing, in perform_job(). In
+	// disk-latency-stats builds, the matching measurement happens when the
+	// completion handler runs (also on the network thread), so the latency
+	// includes both disk queues.
 	j->start_time = clock_type::now();
-#endif
 	// if this happens, it means we started to shut down
 	// the disk threads too early. We have to post all jobs
 	// before the disk threads are shut down
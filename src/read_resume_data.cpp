@@ -387,6 +387,27 @@ namespace {
 			}
 		}
 
+		ret.resume_delta = rd.dict_find_int_value("delta", 0) != 0;
+
+		// deltas may list the pieces completed since the previous save,
+		// rather than storing a bitmask
+		if (bdecode_node const new_pieces = rd.dict_find_string("new-pieces"))
+		{
+			std::vector<int> pieces;
+			char const* ptr = new_pieces.string_ptr();
+			int max_piece = -1;
+			for (int i = 3; i < new_pieces.string_length(); i += 4)
+			{
+				auto const p = aux::read_uint32(ptr);
+				if (p >= std::uint32_t(piece_limit)) continue;
+				pieces.push_back(int(p));
+				max_piece = std::max(max_piece, int(p));
+			}
+			ret.have_pieces.resize(max_piece + 1, false);
+			for (int const p : pieces)
+				ret.have_pieces.set_bit(piece_index_t(p));
+		}
+
 		if (bdecode_node const verified = rd.dict_find_string("verified"))
 		{
 			string_view const str = verified.string_value();
@@ -472,6 +493,88 @@ namespace {
 		return read_resume_data(rd, ec, cfg.max_pieces);
 	}
 
+	add_torrent_params read_resume_data(span<char const> base
+		, span<std::vector<char> const> deltas, error_code& ec
+		, load_torrent_limits const& cfg)
+	{
+		add_torrent_params ret = read_resume_data(base, ec, cfg);
+		if (ec) return ret;
+
+		// the base must be a full save, it's what the deltas build on
+		if (ret.resume_delta)
+		{
+			ec = errors::invalid_file_tag;
+			return ret;
+		}
+
+		for (auto const& d : deltas)
+		{
+			add_torrent_params delta = read_resume_data(d, ec, cfg);
+			if (ec) return ret;
+			if (delta.info_hashes != ret.info_hashes)
+			{
+				ec = errors::mismatching_info_hash;
+				return ret;
+			}
+			apply_resume_delta(ret, std::move(delta));
+		}
+		return ret;
+	}
+
+	void apply_resume_delta(add_torrent_params& base, add_torrent_params delta)
+	{
+		// a full save replaces everything saved before it
+		if (!delta.resume_delta)
+		{
+			base = std::move(delta);
+			return;
+		}
+
+		// the pieces we had before are still ours
+		auto& have = delta.have_pieces;
+		if (have.size() < base.have_pieces.size())
+			have.resize(base.have_pieces.size(), false);
+		char* dst = have.data();
+		char const* src = base.have_pieces.data();
+		for (int i = 0; i < base.have_pieces.num_bytes(); ++i)
+			dst[i] |= src[i];
+
+		// empty trees are unchanged since the previous save
+		if (delta.merkle_trees.empty())
+		{
+			delta.merkle_trees = std::move(base.merkle_trees);
+			delta.merkle_tree_mask = std::move(base.merkle_tree_mask);
+			delta.verified_leaf_hashes = std::move(base.verified_leaf_hashes);
+		}
+		else
+		{
+			for (auto const f : delta.merkle_trees.range())
+			{
+				if (!delta.merkle_trees[f].empty()
+					|| f >= base.merkle_trees.end_index())
+					continue;
+
+				delta.merkle_trees[f] = std::move(base.merkle_trees[f]);
+				if (f < delta.merkle_tree_mask.end_index()
+					&& f < base.merkle_tree_mask.end_index())
+					delta.merkle_tree_mask[f] = std::move(base.merkle_tree_mask[f]);
+				if (f < delta.verified_leaf_hashes.end_index()
+					&& f < base.verified_leaf_hashes.end_index())
+					delta.verified_leaf_hashes[f] = std::move(base.verified_leaf_hashes[f]);
+			}
+		}
+
+		if (delta.piece_priorities.empty())
+			delta.piece_priorities = std::move(base.piece_priorities);
+		if (delta.file_priorities.empty())
+			delta.file_priorities = std::move(base.file_priorities);
+		if (!delta.ti)
+			delta.ti = std::move(base.ti);
+
+		delta.resume_delta = false;
+		base = std::move(delta);
+	}
+
 	add_torrent_params read_resume_data(bdecode_node const& rd, int const piece_limit)
 	{
 		error_code ec;
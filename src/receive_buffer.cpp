@@ -15,9 +15,83 @@ see LICENSE file.
 #include "libtorrent/aux_/numeric_cast.hpp"
 #include "libtorrent/span.hpp"
 
+#include <array>
+#include <cstring> // for memcpy
+
 namespace libtorrent {
 namespace aux {
 
+namespace {
+
+	// receive buffers are re-allocated as the messages they hold change size,
+	// typically flipping between small protocol messages and 16 kiB blocks.
+	// Rather than going back to the heap every time, the network thread keeps
+	// a small cache of recently released buffers to pick from.
+	struct buffer_cache
+	{
+		// returns a buffer of at least ``size`` bytes. A cached buffer is only
+		// used if it's not much larger than requested, to not defeat the
+		// shrinking of receive buffers
+		buffer allocate(std::ptrdiff_t const size)
+		{
+			int best = -1;
+			for (int i = 0; i < m_num_buffers; ++i)
+			{
+				std::ptrdiff_t const s = m_buffers[std::size_t(i)].size();
+				if (s < size || s > size + size / 8) continue;
+				if (best == -1 || s < m_buffers[std::size_t(best)].size()) best = i;
+			}
+			if (best == -1) return buffer(size);
+
+			buffer ret = std::move(m_buffers[std::size_t(best)]);
+			--m_num_buffers;
+			if (best != m_num_buffers)
+				m_buffers[std::size_t(best)] = std::move(m_buffers[std::size_t(m_num_buffers)]);
+			return ret;
+		}
+
+		// hands a buffer back to the cache. If the cache is full, or the buffer
+		// is too large to be worth holding on to, it's freed
+		void release(buffer b) noexcept
+		{
+			if (b.empty() || b.size() > max_buffer_size) return;
+			if (m_num_buffers == max_buffers) return;
+			m_buffers[std::size_t(m_num_buffers)] = std::move(b);
+			++m_num_buffers;
+		}
+
+	private:
+
+		static constexpr int max_buffers = 16;
+		static constexpr std::ptrdiff_t max_buffer_size = 128 * 1024;
+
+		std::array<buffer, max_buffers> m_buffers;
+		int m_num_buffers = 0;
+	};
+
+	buffer_cache& thread_buffer_cache()
+	{
+		thread_local static buffer_cache cache;
+		return cache;
+	}
+}
+
+receive_buffer::~receive_buffer()
+{
+	thread_buffer_cache().release(std::move(m_recv_buffer));
+}
+
+void receive_buffer::replace_buffer(int const size, span<char const> const keep)
+{
+	TORRENT_ASSERT(keep.size() <= size);
+	buffer_cache& cache = thread_buffer_cache();
+	buffer new_buffer = cache.allocate(size);
+	if (!keep.empty())
+		std::memcpy(new_buffer.data(), keep.data(), std::size_t(keep.size()));
+	cache.release(std::move(m_recv_buffer));
+	m_recv_buffer = std::move(new_buffer);
+}
+
 int receive_buffer::max_receive() const
 {
 	return int(m_recv_buffer.size()) - m_recv_end;
@@ -35,8 +109,7 @@ span<char> receive_buffer::reserve(int const size)
 	if (int(m_recv_buffer.size()) < m_recv_end + size)
 	{
 		int const new_size = std::max(m_recv_end + size, m_packet_size);
-		buffer new_buffer(new_size, {m_recv_buffer.data(), m_recv_end});
-		m_recv_buffer = std::move(new_buffer);
+		replace_buffer(new_size, {m_recv_buffer.data(), m_recv_end});
 
 		// since we just increased the size of the buffer, reset the watermark to
 		// start at our new size (avoid flapping the buffer size)
@@ -57,8 +130,7 @@ void receive_buffer::grow(int const limit)
 		? m_packet_size : std::min(current_size * 3 / 2, limit);
 
 	// re-allocate the buffer and copy over the part of it that's used
-	buffer new_buffer(new_size, {m_recv_buffer.data(), m_recv_end});
-	m_recv_buffer = std::move(new_buffer);
+	replace_buffer(new_size, {m_recv_buffer.data(), m_recv_end});
 
 	// since we just increased the size of the buffer, reset the watermark to
 	// start at our new size (avoid flapping the buffer size)
@@ -169,13 +241,11 @@ void receive_buffer::normalize(int const force_shrink)
 	{
 		int const target_size = std::max(std::max(force_shrink
 			, int(bytes_to_shift.size())), m_packet_size);
-		buffer new_buffer(target_size, bytes_to_shift);
-		m_recv_buffer = std::move(new_buffer);
+		replace_buffer(target_size, bytes_to_shift);
 	}
 	else if (shrink_buffer)
 	{
-		buffer new_buffer(numeric_cast<std::ptrdiff_t>(m_watermark.mean()), bytes_to_shift);
-		m_recv_buffer = std::move(new_buffer);
+		replace_buffer(numeric_cast<int>(m_watermark.mean()), bytes_to_shift);
 	}
 	else if (m_recv_end > m_recv_start
 		&& m_recv_start > 0)
@@ -0,0 +1,711 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "libtorrent/resume_store.hpp"
+#include "libtorrent/add_torrent_params.hpp"
+#include "libtorrent/read_resume_data.hpp"
+#include "libtorrent/write_resume_data.hpp"
+#include "libtorrent/info_hash.hpp"
+#include "libtorrent/aux_/file_pointer.hpp"
+#include "libtorrent/aux_/io_bytes.hpp"
+#include "libtorrent/aux_/path.hpp"
+#include "libtorrent/aux_/platform_util.hpp" // for set_thread_name
+
+#include "libtorrent/aux_/disable_warnings_push.hpp"
+#include <boost/crc.hpp>
+#include "libtorrent/aux_/disable_warnings_pop.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef TORRENT_WINDOWS
+#include <io.h> // for _commit
+#else
+#include <unistd.h> // for fsync
+#endif
+
+namespace libtorrent {
+namespace aux {
+
+namespace {
+
+	// a store starts with this magic, followed by a 32 bit version
+	char const file_magic[8] = {'l', 't', 'r', 'e', 's', 'u', 'm', 'e'};
+	std::uint32_t const file_version = 1;
+	int const file_header_size = 12;
+
+	// every record has this header, followed by the payload, which is the
+	// bencoded resume data (or nothing, for removals)
+	//
+	//   uint32: payload size
+	//   uint32: CRC-32 of the rest of the header and the payload
+	//   uint8: record_type
+	//   20 bytes: v1 info-hash
+	//   32 bytes: v2 info-hash
+	enum record_type : std::uint8_t { full_record, delta_record, remove_record };
+	int const record_header_size = 4 + 4 + 1 + 20 + 32;
+
+	// stores smaller than this aren't worth compacting
+	std::int64_t const min_compact_size = 1024 * 1024;
+
+	std::uint32_t record_crc(char const* ptr, std::size_t const len)
+	{
+		boost::crc_32_type crc;
+		crc.process_bytes(ptr, len);
+		return crc.checksum();
+	}
+
+	std::vector<char> make_record(record_type const t, info_hash_t const& ih
+		, span<char const> payload)
+	{
+		std::vector<char> ret;
+		ret.reserve(std::size_t(record_header_size) + std::size_t(payload.size()));
+		auto out = std::back_inserter(ret);
+		write_uint32(payload.size(), out);
+		write_uint32(0, out);
+		write_uint8(t, out);
+		std::copy(ih.v1.begin(), ih.v1.end(), out);
+		std::copy(ih.v2.begin(), ih.v2.end(), out);
+		ret.insert(ret.end(), payload.begin(), payload.end());
+
+		char* crc = ret.data() + 4;
+		write_uint32(record_crc(ret.data() + 8, ret.size() - 8), crc);
+		return ret;
+	}
+
+	// parses the record at the start of ``buf``. Returns its size, including
+	// the header, or 0 if it's truncated or corrupt
+	int parse_record(span<char const> buf, record_type& t, info_hash_t& ih
+		, span<char const>& payload)
+	{
+		if (buf.size() < record_header_size) return 0;
+		char const* ptr = buf.data();
+		std::uint32_t const size = read_uint32(ptr);
+		std::uint32_t const crc = read_uint32(ptr);
+		if (size > std::uint32_t(std::numeric_limits<int>::max() - record_header_size)
+			|| std::int64_t(size) > buf.size() - record_header_size)
+			return 0;
+		if (record_crc(buf.data() + 8, std::size_t(record_header_size - 8) + size) != crc)
+			return 0;
+		std::uint8_t const type = read_uint8(ptr);
+		if (type > remove_record) return 0;
+		t = record_type(type);
+		ih.v1.assign(ptr);
+		ptr += ih.v1.size();
+		ih.v2.assign(ptr);
+		ptr += ih.v2.size();
+		payload = {ptr, int(size)};
+		return record_header_size + int(size);
+	}
+
+	file_pointer open_file(std::string const& path, char const* mode, error_code& ec)
+	{
+#ifdef TORRENT_WINDOWS
+		std::wstring const wmode(mode, mode + std::strlen(mode));
+		file_pointer ret(::_wfopen(convert_to_native_path_string(path).c_str()
+			, wmode.c_str()));
+#else
+		file_pointer ret(::fopen(path.c_str(), mode));
+#endif
+		if (ret.file() == nullptr)
+			ec.assign(errno, generic_category());
+		return ret;
+	}
+
+	bool write_all(FILE* f, span<char const> buf, error_code& ec)
+	{
+		if (std::fwrite(buf.data(), 1, std::size_t(buf.size()), f) == std::size_t(buf.size()))
+			return true;
+		ec.assign(errno, generic_category());
+		return false;
+	}
+
+	bool flush_to_disk(FILE* f, error_code& ec)
+	{
+		if (std::fflush(f) != 0)
+		{
+			ec.assign(errno, generic_category());
+			return false;
+		}
+#ifdef TORRENT_WINDOWS
+		if (::_commit(::_fileno(f)) != 0)
+#else
+		if (::fsync(::fileno(f)) != 0)
+#endif
+		{
+			ec.assign(errno, generic_category());
+			return false;
+		}
+		return true;
+	}
+}
+
+	struct resume_store_impl
+	{
+		explicit resume_store_impl(std::string p)
+			: m_path(std::move(p))
+			, m_thread([this] { thread_fun(); })
+		{}
+
+		~resume_store_impl()
+		{
+			{
+				std::lock_guard<std::mutex> l(m_mutex);
+				m_abort = true;
+			}
+			m_cond.notify_all();
+			m_thread.join();
+		}
+
+		resume_store_impl(resume_store_impl const&) = delete;
+		resume_store_impl& operator=(resume_store_impl const&) = delete;
+
+		void post(std::function<void()> j)
+		{
+			{
+				std::lock_guard<std::mutex> l(m_mutex);
+				m_jobs.push_back(std::move(j));
+			}
+			m_cond.notify_one();
+		}
+
+		// runs f on the store's thread and waits for its result
+		template <typename Fun>
+		auto call(Fun f) -> decltype(f())
+		{
+			std::packaged_task<decltype(f())()> task(std::move(f));
+			auto ret = task.get_future();
+			post([&task] { task(); });
+			return ret.get();
+		}
+
+		// everything below is only called on the store's thread
+
+		// reads the whole file, to rebuild m_index. If ``out`` is set, the
+		// resume data of every torrent is folded and returned in it
+		void scan(std::vector<add_torrent_params>* out, error_code& ec);
+
+		void save(add_torrent_params const& atp);
+		void remove(info_hash_t const& ih);
+		void compact(error_code& ec);
+		void sync();
+		void set_error(error_code const& ec) { if (!m_error) m_error = ec; }
+		error_code take_error();
+
+	private:
+
+		void thread_fun();
+		void append(record_type t, info_hash_t const& ih, span<char const> payload);
+		void index_record(record_type t, info_hash_t const& ih
+			, std::int64_t offset, int size);
+		std::vector<char> read_record(FILE* f, std::int64_t offset, int size
+			, error_code& ec);
+
+		struct torrent_entry
+		{
+			// torrents are kept in the order they were first saved in
+			std::uint64_t order = 0;
+
+			// the offset and size of the torrent's most recent full save, and
+			// of every delta saved after it
+			std::vector<std::pair<std::int64_t, int>> records;
+		};
+
+		std::string const m_path;
+
+		// the file is opened for appending, the first time we write to it
+		file_pointer m_file;
+
+		// the size of the file, up to the end of the last valid record
+		std::int64_t m_file_size = 0;
+
+		// the total size of the records in m_index. Everything else in the
+		// file is stale and is dropped when compacting
+		std::int64_t m_live_size = 0;
+
+		std::uint64_t m_next_order = 0;
+		std::unordered_map<info_hash_t, torrent_entry> m_index;
+
+		// set once m_index reflects what's in the file
+		bool m_scanned = false;
+
+		// set if the file has a partial or corrupt record at the end, or a
+		// write failed. Records appended after that would be lost, so the
+		// store is compacted before writing to it again
+		bool m_torn_tail = false;
+
+		// set when there are records written since the file was last synced
+		bool m_dirty = false;
+
+		// the first error writing to the store failed with, reported by
+		// flush()
+		error_code m_error;
+
+		std::mutex m_mutex;
+		std::condition_variable m_cond;
+		std::deque<std::function<void()>> m_jobs;
+		bool m_abort = false;
+
+		std::thread m_thread;
+	};
+
+	void resume_store_impl::thread_fun()
+	{
+		set_thread_name("libtorrent-resume-store");
+
+		std::unique_lock<std::mutex> l(m_mutex);
+		for (;;)
+		{
+			m_cond.wait(l, [this] { return m_abort || !m_jobs.empty(); });
+
+			// the queue is drained before exiting
+			if (m_jobs.empty()) break;
+
+			std::deque<std::function<void()>> jobs;
+			jobs.swap(m_jobs);
+			l.unlock();
+
+			for (auto& j : jobs)
+			{
+				try
+				{
+					j();
+				}
+				catch (system_error const& e)
+				{
+					set_error(e.code());
+				}
+				catch (std::bad_alloc const&)
+				{
+					set_error(error_code(boost::system::errc::not_enough_memory
+						, generic_category()));
+				}
+			}
+
+			// records are synced to disk once per batch, rather than once
+			// per record
+			sync();
+			l.lock();
+		}
+	}
+
+	void resume_store_impl::index_record(record_type const t
+		, info_hash_t const& ih, std::int64_t const offset, int const size)
+	{
+		if (t == remove_record)
+		{
+			auto const i = m_index.find(ih);
+			if (i == m_index.end()) return;
+			for (auto const& r : i->second.records) m_live_size -= r.second;
+			m_index.erase(i);
+			return;
+		}
+
+		auto const [i, added] = m_index.try_emplace(ih);
+		torrent_entry& e = i->second;
+		if (added) e.order = m_next_order++;
+
+		// a full save makes everything saved before it stale
+		if (t == full_record)
+		{
+			for (auto const& r : e.records) m_live_size -= r.second;
+			e.records.clear();
+		}
+		e.records.emplace_back(offset, size);
+		m_live_size += size;
+	}
+
+	void resume_store_impl::scan(std::vector<add_torrent_params>* out
+		, error_code& ec)
+	{
+		m_index.clear();
+		m_live_size = 0;
+		m_file_size = 0;
+		m_next_order = 0;
+		m_torn_tail = false;
+
+		// the records we've appended must be visible to the file handle we
+		// read from
+		if (m_file.file() != nullptr) std::fflush(m_file.file());
+
+		std::vector<char> buf;
+		{
+			file_pointer f = open_file(m_path, "rb", ec);
+			if (ec == boost::system::errc::no_such_file_or_directory)
+			{
+				// the store is empty
+				ec.clear();
+				m_scanned = true;
+				return;
+			}
+			if (ec) return;
+
+			char chunk[0x10000];
+			for (;;)
+			{
+				std::size_t const n = std::fread(chunk, 1, sizeof(chunk), f.file());
+				buf.insert(buf.end(), chunk, chunk + n);
+				if (n < sizeof(chunk)) break;
+			}
+			if (std::ferror(f.file()))
+			{
+				ec.assign(errno, generic_category());
+				return;
+			}
+		}
+
+		span<char const> const b(buf);
+		if (b.size() < file_header_size)
+		{
+			// the header was never completely written
+			m_torn_tail = !b.empty();
+			m_scanned = true;
+			return;
+		}
+
+		char const* ptr = b.data() + sizeof(file_magic);
+		if (std::memcmp(b.data(), file_magic, sizeof(file_magic)) != 0
+			|| read_uint32(ptr) != file_version)
+		{
+			ec = errors::invalid_file_tag;
+			return;
+		}
+
+		std::unordered_map<info_hash_t, add_torrent_params> state;
+		std::int64_t offset = file_header_size;
+		while (offset < b.size())
+		{
+			record_type t;
+			info_hash_t ih;
+			span<char const> payload;
+			int const len = parse_record(b.subspan(offset), t, ih, payload);
+			if (len == 0)
+			{
+				m_torn_tail = true;
+				break;
+			}
+			index_record(t, ih, offset, len);
+			offset += len;
+
+			if (out == nullptr) continue;
+
+			if (t == remove_record)
+			{
+				state.erase(ih);
+				continue;
+			}
+
+			error_code err;
+			add_torrent_params atp = read_resume_data(payload, err);
+			if (err) continue;
+			auto const i = state.find(ih);
+			if (i == state.end() || t == full_record)
+				state[ih] = std::move(atp);
+			else
+				apply_resume_delta(i->second, std::move(atp));
+		}
+		m_file_size = offset;
+		m_scanned = true;
+
+		if (out == nullptr) return;
+
+		std::vector<std::pair<std::uint64_t, info_hash_t>> order;
+		order.reserve(m_index.size());
+		for (auto const& e : m_index)
+			order.emplace_back(e.second.order, e.first);
+		std::sort(order.begin(), order.end());
+
+		out->reserve(order.size());
+		for (auto const& o : order)
+		{
+			auto const i = state.find(o.second);
+			// deltas without the full save they apply to can't be used
+			if (i == state.end() || i->second.resume_delta) continue;
+			out->push_back(std::move(i->second));
+		}
+	}
+
+	std::vector<char> resume_store_impl::read_record(FILE* f
+		, std::int64_t const offset, int const size, error_code& ec)
+	{
+		std::vector<char> ret(std::size_t(size), '\0');
+		if (portable_fseeko(f, offset, SEEK_SET) != 0
+			|| std::fread(ret.data(), 1, ret.size(), f) != ret.size())
+		{
+			ec.assign(errno, generic_category());
+			return {};
+		}
+		return ret;
+	}
+
+	void resume_store_impl::append(record_type const t, info_hash_t const& ih
+		, span<char const> payload)
+	{
+		error_code ec;
+		if (!m_scanned)
+		{
+			scan(nullptr, ec);
+			if (ec)
+			{
+				set_error(ec);
+				return;
+			}
+		}
+
+		if (m_torn_tail)
+		{
+			compact(ec);
+			if (ec)
+			{
+				set_error(ec);
+				return;
+			}
+		}
+
+		if (m_file.file() == nullptr)
+		{
+			m_file = open_file(m_path, "ab+", ec);
+			if (ec)
+			{
+				set_error(ec);
+				return;
+			}
+		}
+
+		if (m_file_size == 0)
+		{
+			char header[file_header_size];
+			std::memcpy(header, file_magic, sizeof(file_magic));
+			char* ptr = header + sizeof(file_magic);
+			write_uint32(file_version, ptr);
+			if (!write_all(m_file.file(), header, ec))
+			{
+				m_torn_tail = true;
+				set_error(ec);
+				return;
+			}
+			m_file_size = file_header_size;
+		}
+
+		std::vector<char> const rec = make_record(t, ih, payload);
+		if (!write_all(m_file.file(), rec, ec))
+		{
+			m_torn_tail = true;
+			set_error(ec);
+			return;
+		}
+		index_record(t, ih, m_file_size, int(rec.size()));
+		m_file_size += std::int64_t(rec.size());
+		m_dirty = true;
+
+		if (m_file_size > min_compact_size
+			&& m_file_size > file_header_size + 2 * m_live_size)
+		{
+			compact(ec);
+			if (ec) set_error(ec);
+		}
+	}
+
+	void resume_store_impl::save(add_torrent_params const& atp)
+	{
+		std::vector<char> const buf = write_resume_data_buf(atp);
+		append(atp.resume_delta ? delta_record : full_record, atp.info_hashes, buf);
+	}
+
+	void resume_store_impl::remove(info_hash_t const& ih)
+	{
+		if (m_scanned && m_index.find(ih) == m_index.end()) return;
+		append(remove_record, ih, {});
+	}
+
+	void resume_store_impl::compact(error_code& ec)
+	{
+		if (!m_scanned)
+		{
+			scan(nullptr, ec);
+			if (ec) return;
+		}
+
+		if (m_file.file() != nullptr) std::fflush(m_file.file());
+
+		std::string const tmp = m_path + ".tmp";
+		{
+			file_pointer in;
+			if (!m_index.empty())
+			{
+				in = open_file(m_path, "rb", ec);
+				if (ec) return;
+			}
+
+			file_pointer out = open_file(tmp, "wb", ec);
+			if (ec) return;
+
+			char header[file_header_size];
+			std::memcpy(header, file_magic, sizeof(file_magic));
+			char* ptr = header + sizeof(file_magic);
+			write_uint32(file_version, ptr);
+			if (!write_all(out.file(), header, ec)) return;
+
+			std::vector<std::pair<std::uint64_t, torrent_entry*>> order;
+			order.reserve(m_index.size());
+			for (auto& e : m_index)
+				order.emplace_back(e.second.order, &e.second);
+			std::sort(order.begin(), order.end()
+				, [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+
+			// the new offsets are only applied once the new file has
+			// replaced the old one
+			std::vector<std::pair<std::int64_t, int>> new_records;
+			new_records.reserve(order.size());
+			std::int64_t offset = file_header_size;
+			for (auto const& o : order)
+			{
+				torrent_entry const& e = *o.second;
+				std::vector<char> rec;
+				info_hash_t ih;
+				add_torrent_params atp;
+				for (auto const& r : e.records)
+				{
+					std::vector<char> const buf = read_record(in.file(), r.first, r.second, ec);
+					if (ec) return;
+					if (e.records.size() == 1)
+					{
+						rec = buf;
+						break;
+					}
+
+					record_type t;
+					span<char const> payload;
+					if (parse_record(buf, t, ih, payload) == 0)
+					{
+						ec = errors::invalid_file_tag;
+						return;
+					}
+					add_torrent_params a = read_resume_data(payload, ec);
+					if (ec) return;
+					if (&r == &e.records.front()) atp = std::move(a);
+					else apply_resume_delta(atp, std::move(a));
+				}
+				if (rec.empty())
+				{
+					rec = make_record(atp.resume_delta ? delta_record : full_record
+						, ih, write_resume_data_buf(atp));
+				}
+
+				if (!write_all(out.file(), rec, ec)) return;
+				new_records.emplace_back(offset, int(rec.size()));
+				offset += std::int64_t(rec.size());
+			}
+
+			if (!flush_to_disk(out.file(), ec)) return;
+
+			// the old file must be closed before it can be replaced, on
+			// windows
+			m_file = file_pointer();
+			in = file_pointer();
+			out = file_pointer();
+
+			libtorrent::rename(tmp, m_path, ec);
+			if (ec)
+			{
+				// windows doesn't replace existing files when renaming
+				ec.clear();
+				libtorrent::remove(m_path, ec);
+				if (!ec) libtorrent::rename(tmp, m_path, ec);
+				if (ec) return;
+			}
+
+			m_live_size = 0;
+			for (std::size_t i = 0; i < order.size(); ++i)
+			{
+				order[i].second->records.assign(1, new_records[i]);
+				m_live_size += new_records[i].second;
+			}
+			m_file_size = offset;
+		}
+		m_torn_tail = false;
+		m_dirty = false;
+	}
+
+	void resume_store_impl::sync()
+	{
+		if (!m_dirty || m_file.file() == nullptr) return;
+		error_code ec;
+		if (!flush_to_disk(m_file.file(), ec)) set_error(ec);
+		m_dirty = false;
+	}
+
+	error_code resume_store_impl::take_error()
+	{
+		error_code ret = m_error;
+		m_error.clear();
+		return ret;
+	}
+}
+
+	resume_store::resume_store(std::string path)
+		: m_impl(std::make_unique<aux::resume_store_impl>(std::move(path)))
+	{}
+
+	resume_store::~resume_store() = default;
+
+	std::vector<add_torrent_params> resume_store::load(error_code& ec)
+	{
+		aux::resume_store_impl& s = *m_impl;
+		std::vector<add_torrent_params> ret;
+		ec = s.call([&]
+		{
+			error_code e;
+			s.scan(&ret, e);
+			return e;
+		});
+		return ret;
+	}
+
+	void resume_store::save(add_torrent_params atp)
+	{
+		aux::resume_store_impl& s = *m_impl;
+		m_impl->post([&s, p = std::move(atp)] { s.save(p); });
+	}
+
+	void resume_store::remove(info_hash_t const& ih)
+	{
+		aux::resume_store_impl& s = *m_impl;
+		m_impl->post([&s, ih] { s.remove(ih); });
+	}
+
+	error_code resume_store::flush()
+	{
+		aux::resume_store_impl& s = *m_impl;
+		return s.call([&]
+		{
+			s.sync();
+			return s.take_error();
+		});
+	}
+
+	void resume_store::compact()
+	{
+		aux::resume_store_impl& s = *m_impl;
+		m_impl->post([&s]
+		{
+			error_code ec;
+			s.compact(ec);
+			if (ec) s.set_error(ec);
+		});
+	}
+}
@@ -20,6 +20,7 @@ see LICENSE file.
 #include "libtorrent/peer_class.hpp"
 #include "libtorrent/peer_class_type_filter.hpp"
 #include "libtorrent/aux_/scope_end.hpp"
+#include "libtorrent/aux_/handler_trace.hpp"
 
 #if TORRENT_ABI_VERSION == 1
 #include "libtorrent/read_resume_data.hpp"
@@ -37,6 +38,7 @@ namespace libtorrent {
 		if (!s) aux::throw_ex<system_error>(errors::invalid_session_handle);
 		dispatch(s->get_context(), [s, f, packed_args = std::make_tuple(std::forward<Args>(a)...)]() mutable
 		{
+			TORRENT_TRACE_SCOPE("session_handle call");
 #ifndef BOOST_NO_EXCEPTIONS
 			try {
 #endif
@@ -70,6 +72,7 @@ namespace libtorrent {
 		std::exception_ptr ex;
 		dispatch(s->get_context(), [s, f, &done, &ex, packed_args = std::make_tuple(std::forward<Args>(a)...)]() mutable
 		{
+			TORRENT_TRACE_SCOPE("session_handle call");
 #ifndef BOOST_NO_EXCEPTIONS
 			try {
 #endif
@@ -105,6 +108,7 @@ namespace libtorrent {
 		std::exception_ptr ex;
 		dispatch(s->get_context(), [s, f, &r, &done, &ex, packed_args = std::make_tuple(std::forward<Args>(a)...)]() mutable
 		{
+			TORRENT_TRACE_SCOPE("session_handle call");
 #ifndef BOOST_NO_EXCEPTIONS
 			try {
 #endif
@@ -177,6 +181,11 @@ namespace libtorrent {
 		async_call(&session_impl::post_torrent_updates, flags);
 	}
 
+	void session_handle::post_status_deltas(status_field_t const fields)
+	{
+		async_call(&session_impl::post_status_deltas, fields);
+	}
+
 	void session_handle::post_session_stats()
 	{
 		async_call(&session_impl::post_session_stats);
@@ -461,6 +470,37 @@ namespace {
 		async_call(&session_impl::async_add_torrent, std::move(p));
 	}
 
+	void session_handle::async_add_torrents(std::vector<add_torrent_params> params)
+	{
+		for (auto& p : params)
+		{
+#ifndef BOOST_NO_EXCEPTIONS
+			if (p.save_path.empty())
+				aux::throw_ex<system_error>(error_code(errors::invalid_save_path));
+#else
+			TORRENT_ASSERT_PRECOND(!p.save_path.empty());
+#endif
+
+#if TORRENT_ABI_VERSION < 3
+			if (!p.info_hashes.has_v1() && !p.info_hashes.has_v2() && !p.ti)
+				p.info_hashes.v1 = p.info_hash;
+#endif
+
+			// the internal torrent object keeps and mutates state in the
+			// torrent_info object. We can't let that leak back to the client
+			if (p.ti)
+				p.ti = std::make_shared<torrent_info>(*p.ti);
+
+			p.save_path = complete(p.save_path);
+
+#if TORRENT_ABI_VERSION == 1
+			handle_backwards_compatible_resume_data(p);
+#endif
+		}
+
+		async_call(&session_impl::async_add_torrents, std::move(params));
+	}
+
 #ifndef BOOST_NO_EXCEPTIONS
 #if TORRENT_ABI_VERSION == 1
 	// if the torrent already exists, this will throw duplicate_torrent
@@ -89,6 +89,7 @@ see LICENSE file.
 #include "libtorrent/aux_/ffs.hpp"
 #include "libtorrent/aux_/array.hpp"
 #include "libtorrent/aux_/set_traffic_class.hpp"
+#include "libtorrent/aux_/handler_trace.hpp"
 
 #ifndef TORRENT_DISABLE_LOGGING
 
@@ -1030,6 +1031,10 @@ bool ssl_server_name_callback(ssl::stream_handle_type stream_handle, std::string
 
 		m_close_file_timer.cancel();
 
+#if !defined TORRENT_DISABLE_ENCRYPTION
+		m_dh_keys.abort();
+#endif
+
 		// abort the main thread
 		m_abort = true;
 		error_code ec;
@@ -2840,6 +2845,14 @@ retry:
 			, s->udp_handler_storage, *this));
 	}
 
+#ifndef TORRENT_BUILD_SIMULATOR
+	namespace {
+		// the max number of connections picked up from a listen socket's
+		// backlog per completed async_accept()
+		constexpr int max_accept_batch = 32;
+	}
+#endif
+
 	void session_impl::async_accept(std::shared_ptr<tcp::acceptor> const& listener
 		, transport const ssl)
 #ifndef BOOST_NO_EXCEPTIONS
@@ -2947,8 +2960,34 @@ retry:
 			}
 			return;
 		}
+		accept_connection(std::move(s), listener, ssl);
+
+#ifndef TORRENT_BUILD_SIMULATOR
+		// under a burst of incoming connections, more of them are likely
+		// waiting in the backlog already. Pick those up right away, rather
+		// than making a round-trip through the io_context for each one.
+		// The listen socket is only put in non-blocking mode for the
+		// duration of this loop, since asio fails outstanding async_accept()
+		// operations with would_block on sockets in that mode
+		listener->non_blocking(true, ec);
+		if (!ec)
+		{
+			for (int i = 1; i < max_accept_batch; ++i)
+			{
+				true_tcp_socket next(m_io_context);
+				listener->accept(next, ec);
+				if (ec) break;
+				accept_connection(std::move(next), listener, ssl);
+			}
+			listener->non_blocking(false, ec);
+		}
+#endif
 		async_accept(listener, ssl);
+	}
 
+	void session_impl::accept_connection(true_tcp_socket s
+		, std::shared_ptr<tcp::acceptor> const& listener, transport const ssl)
+	{
 		// don't accept any connections from our local listen sockets if we're
 		// using a proxy. We should only accept peers via the proxy, never
 		// directly.
@@ -3074,6 +3113,28 @@ retry:
 
 #endif // TORRENT_SSL_PEERS
 
+	namespace {
+
+	// the granularity of m_handshake_timeouts is one second
+	std::int64_t timeout_tick(time_point const t)
+	{
+		return total_seconds(t.time_since_epoch());
+	}
+
+	// the first tick at which an incoming connection that still hasn't been
+	// attached to a torrent should be disconnected
+	std::int64_t handshake_deadline(peer_connection const& p
+		, session_settings const& sett)
+	{
+		int timeout = sett.get_int(settings_pack::handshake_timeout);
+#if TORRENT_USE_I2P
+		timeout *= is_i2p(p.get_socket()) ? 4 : 1;
+#endif
+		return timeout_tick(p.connected_time() + seconds(timeout)) + 1;
+	}
+
+	} // anonymous namespace
+
 	void session_impl::incoming_connection(socket_type s)
 	{
 		TORRENT_ASSERT(is_single_thread());
@@ -3316,10 +3377,32 @@ retry:
 			// connection to be added to the undead peers now.
 			m_undead_peers.reserve(m_undead_peers.size() + m_connections.size() + 1);
 			m_connections.insert(c);
+			m_handshake_timeouts.schedule(c, handshake_deadline(*c, m_settings));
 			c->start();
 		}
 	}
 
+	void session_impl::check_handshake_timeouts(time_point const now)
+	{
+		// connections that have been attached to a torrent by now are ticked
+		// through the torrent's second_tick, and don't need to be tracked
+		// here anymore. The remaining ones are either timed out, or had their
+		// deadline pushed out (by a change to handshake_timeout)
+		m_handshake_timeouts.advance(timeout_tick(now)
+			, [&](std::weak_ptr<peer_connection> const& wp)
+		{
+			std::shared_ptr<peer_connection> p = wp.lock();
+			if (!p || p->is_disconnecting()) return;
+			if (!p->associated_torrent().expired()) return;
+
+			std::int64_t const deadline = handshake_deadline(*p, m_settings);
+			if (timeout_tick(now) >= deadline)
+				p->disconnect(errors::timed_out, operation_t::bittorrent);
+			else
+				m_handshake_timeouts.schedule(p, deadline);
+		});
+	}
+
 	void session_impl::close_connection(peer_connection* p) noexcept
 	{
 		TORRENT_ASSERT(is_single_thread());
@@ -3503,6 +3586,7 @@ retry:
 	void session_impl::on_tick(error_code const& e)
 	{
 		COMPLETE_ASYNC("session_impl::on_tick");
+		TORRENT_TRACE_SCOPE("session_impl::on_tick");
 		m_stats_counters.inc_stats_counter(counters::on_tick_counter);
 
 		TORRENT_ASSERT(is_single_thread());
@@ -3720,22 +3804,7 @@ retry:
 		// check for incoming connections that might have timed out
 		// --------------------------------------------------------------
 
-		for (auto i = m_connections.begin(); i != m_connections.end();)
-		{
-			peer_connection* p = (*i).get();
-			++i;
-			// ignore connections that already have a torrent, since they
-			// are ticked through the torrents' second_tick
-			if (!p->associated_torrent().expired()) continue;
-
-			// TODO: have a separate list for these connections, instead of having to loop through all of them
-			int timeout = m_settings.get_int(settings_pack::handshake_timeout);
-#if TORRENT_USE_I2P
-			timeout *= is_i2p(p->get_socket()) ? 4 : 1;
-#endif
-			if (m_last_tick - p->connected_time () > seconds(timeout))
-				p->disconnect(errors::timed_out, operation_t::bittorrent);
-		}
+		check_handshake_timeouts(now);
 
 		// --------------------------------------------------------------
 		// second_tick every torrent (that wants it)
@@ -4204,6 +4273,7 @@ retry:
 	void session_impl::recalculate_auto_managed_torrents()
 	{
 		INVARIANT_CHECK;
+		TORRENT_TRACE_SCOPE("session_impl::recalculate_auto_managed_torrents");
 
 		m_last_auto_manage = time_now();
 		m_need_auto_manage = false;
@@ -4228,6 +4298,13 @@ retry:
 		int tracker_limit = get_int_setting(settings_pack::active_tracker_limit);
 		int lsd_limit = get_int_setting(settings_pack::active_lsd_limit);
 		int hard_limit = get_int_setting(settings_pack::active_limit);
+		int const hydrated_limit = m_settings.get_int(settings_pack::hydrated_queued_limit);
+
+		// the queued torrents that stay hydrated are the ones next in line to
+		// be started, so those need to be sorted too
+		int const sort_limit = hydrated_limit > 0
+			? std::min(hard_limit, std::numeric_limits<int>::max() - hydrated_limit) + hydrated_limit
+			: hard_limit;
 
 		// if hard_limit is <= 0, all torrents in these lists should be paused.
 		// The order is not relevant
@@ -4243,12 +4320,12 @@ retry:
 				{ return lhs->sequence_number() < rhs->sequence_number(); });
 
 			std::partial_sort(downloaders.begin(), downloaders.begin() +
-				std::min(hard_limit, int(downloaders.size())), downloaders.end()
+				std::min(sort_limit, int(downloaders.size())), downloaders.end()
 				, [](torrent const* lhs, torrent const* rhs)
 				{ return lhs->sequence_number() < rhs->sequence_number(); });
 
 			std::partial_sort(seeds.begin(), seeds.begin() +
-				std::min(hard_limit, int(seeds.size())), seeds.end()
+				std::min(sort_limit, int(seeds.size())), seeds.end()
 				, [this](torrent const* lhs, torrent const* rhs)
 				{ return lhs->seed_rank(m_settings) > rhs->seed_rank(m_settings); });
 		}
@@ -4269,6 +4346,27 @@ retry:
 			auto_manage_torrents(seeds, dht_limit, tracker_limit, lsd_limit
 				, hard_limit, seeding_limit);
 		}
+
+		if (hydrated_limit < 0) return;
+
+		// queued torrents beyond the hydrated limit, in the order they would
+		// be started, are made dormant
+		bool const prefer_seeds = settings().get_bool(settings_pack::auto_manage_prefer_seeds);
+		int hydrated = hydrated_limit;
+		for (auto* list : {prefer_seeds ? &seeds : &downloaders
+			, prefer_seeds ? &downloaders : &seeds})
+		{
+			for (auto* t : *list)
+			{
+				if (!t->is_torrent_paused()) continue;
+				if (hydrated > 0)
+				{
+					--hydrated;
+					continue;
+				}
+				t->make_dormant();
+			}
+		}
 	}
 
 	namespace {
@@ -4611,6 +4709,7 @@ retry:
 	void session_impl::recalculate_unchoke_slots()
 	{
 		TORRENT_ASSERT(is_single_thread());
+		TORRENT_TRACE_SCOPE("session_impl::recalculate_unchoke_slots");
 
 		time_point const now = aux::time_now();
 		time_duration const unchoke_interval = now - m_last_choke;
@@ -4871,12 +4970,12 @@ retry:
 
 #if !defined TORRENT_DISABLE_ENCRYPTION
 	torrent const* session_impl::find_encrypted_torrent(sha1_hash const& info_hash
-		, sha1_hash const& xor_mask)
+		, sha1_hash const& xor_mask, protocol_version& version)
 	{
 		sha1_hash obfuscated = info_hash;
 		obfuscated ^= xor_mask;
 
-		return m_torrents.find_obfuscated(obfuscated);
+		return m_torrents.find_obfuscated(obfuscated, &version);
 	}
 #endif
 
@@ -4975,6 +5074,7 @@ retry:
 	void session_impl::post_torrent_updates(status_flags_t const flags)
 	{
 		INVARIANT_CHECK;
+		TORRENT_TRACE_SCOPE("session_impl::post_torrent_updates");
 
 		TORRENT_ASSERT(is_single_thread());
 
@@ -5014,6 +5114,40 @@ retry:
 		m_alerts.emplace_alert<state_update_alert>(std::move(status));
 	}
 
+	void session_impl::post_status_deltas(status_field_t const fields)
+	{
+		INVARIANT_CHECK;
+		TORRENT_TRACE_SCOPE("session_impl::post_status_deltas");
+
+		TORRENT_ASSERT(is_single_thread());
+
+		std::vector<torrent*>& state_updates
+			= m_torrent_lists[aux::session_impl::torrent_state_updates];
+
+#if TORRENT_USE_ASSERTS
+		m_posting_torrent_updates = true;
+#endif
+
+		std::vector<torrent_status_delta> deltas;
+		deltas.reserve(state_updates.size());
+
+		for (auto& t : state_updates)
+		{
+			TORRENT_ASSERT(t->m_links[aux::session_impl::torrent_state_updates].in_list());
+			deltas.emplace_back();
+			if (!t->status_delta(&deltas.back(), fields))
+				deltas.pop_back();
+			t->clear_in_state_update();
+		}
+		state_updates.clear();
+
+#if TORRENT_USE_ASSERTS
+		m_posting_torrent_updates = false;
+#endif
+
+		m_alerts.emplace_alert<status_delta_alert>(std::move(deltas));
+	}
+
 	void session_impl::post_session_stats()
 	{
 		if (!m_posted_stats_header)
@@ -5090,6 +5224,64 @@ retry:
 		add_torrent(std::move(*params), ec);
 	}
 
+	void session_impl::async_add_torrents(std::vector<add_torrent_params> params)
+	{
+		// make room for the whole batch up-front, rather than growing the
+		// torrent lists and indices one torrent at a time
+		std::size_t const num_torrents = m_torrents.size() + params.size();
+		m_torrents.reserve(num_torrents);
+		for (auto& l : m_torrent_lists)
+			l.reserve(num_torrents);
+
+		bool auto_managed = false;
+		for (auto& p : params)
+		{
+			auto_managed |= bool(p.flags & torrent_flags::auto_managed);
+			error_code ec;
+			add_torrent_internal(std::move(p), ec, true);
+		}
+
+		// the auto-manager is triggered once for the whole batch
+		if (auto_managed) trigger_auto_manage();
+		init_deferred_torrents();
+	}
+
+	void session_impl::deferred_init_done()
+	{
+		TORRENT_ASSERT(m_deferred_checks > 0);
+		--m_deferred_checks;
+		if (m_deferred_init.empty() || m_pending_deferred_init || m_abort) return;
+
+		// this is called from within a torrent's disk job handler. Initialize
+		// the next torrent from a fresh handler
+		m_pending_deferred_init = true;
+		post(m_io_context, [this]{ wrap(&session_impl::init_deferred_torrents); });
+	}
+
+	void session_impl::init_deferred_torrents()
+	{
+		m_pending_deferred_init = false;
+		if (m_abort)
+		{
+			m_deferred_init.clear();
+			return;
+		}
+
+		// the resume data checks are kept to one per disk thread. All checks
+		// issued here are submitted to the disk thread together, by
+		// deferred_submit_jobs()
+		int const limit = std::max(1, m_settings.get_int(settings_pack::aio_threads));
+		while (m_deferred_checks < limit && !m_deferred_init.empty())
+		{
+			std::shared_ptr<torrent> t = m_deferred_init.front().lock();
+			m_deferred_init.pop_front();
+			if (!t || t->is_aborted() || !t->is_init_deferred()) continue;
+
+			++m_deferred_checks;
+			t->init_deferred();
+		}
+	}
+
 #ifndef TORRENT_DISABLE_EXTENSIONS
 	void session_impl::add_extensions_to_torrent(
 		std::shared_ptr<torrent> const& torrent_ptr, client_data_t const userdata)
@@ -5105,6 +5297,12 @@ retry:
 
 	torrent_handle session_impl::add_torrent(add_torrent_params&& params
 		, error_code& ec)
+	{
+		return add_torrent_internal(std::move(params), ec, false);
+	}
+
+	torrent_handle session_impl::add_torrent_internal(add_torrent_params&& params
+		, error_code& ec, bool const batch)
 	{
 		std::shared_ptr<torrent> torrent_ptr;
 
@@ -5160,7 +5358,7 @@ retry:
 		}
 
 		torrent_ptr->set_ip_filter(m_ip_filter);
-		torrent_ptr->start();
+		torrent_ptr->start(batch);
 
 #ifndef TORRENT_DISABLE_EXTENSIONS
 		for (auto& ext : extensions)
@@ -5175,6 +5373,9 @@ retry:
 		TORRENT_ASSERT(info_hash == torrent_ptr->torrent_file().info_hashes());
 		insert_torrent(info_hash, torrent_ptr);
 
+		if (torrent_ptr->is_init_deferred())
+			m_deferred_init.emplace_back(torrent_ptr);
+
         m_alerts.emplace_alert<add_torrent_alert>(handle, std::move(alert_params), ec);
 
 		// once we successfully add the torrent, we can disarm the abort action
@@ -5185,7 +5386,7 @@ retry:
 		// we want to put it off again anyway. So that while we're adding
 		// a boat load of torrents, we postpone the recalculation until
 		// we're done adding them all (since it's kind of an expensive operation)
-		if (flags & torrent_flags::auto_managed)
+		if ((flags & torrent_flags::auto_managed) && !batch)
 		{
 			const int max_downloading = settings().get_int(settings_pack::active_downloads);
 			const int max_seeds = settings().get_int(settings_pack::active_seeds);
@@ -5647,6 +5848,13 @@ retry:
 		m_host_resolver.set_cache_timeout(seconds(timeout));
 	}
 
+	void session_impl::update_dh_key_pool_size()
+	{
+#if !defined TORRENT_DISABLE_ENCRYPTION
+		m_dh_keys.set_size(m_settings.get_int(settings_pack::dh_key_pool_size));
+#endif
+	}
+
 	void session_impl::update_proxy()
 	{
 		for (auto& i : m_listen_sockets)
@@ -31,6 +31,42 @@ namespace {
 { \
 	#category "." #name, counters::name \
 }
+
+#define HISTOGRAM(category, name) \
+	{ #category "." #name "_0", counters::name + 0 }, \
+	{ #category "." #name "_1", counters::name + 1 }, \
+	{ #category "." #name "_2", counters::name + 2 }, \
+	{ #category "." #name "_3", counters::name + 3 }, \
+	{ #category "." #name "_4", counters::name + 4 }, \
+	{ #category "." #name "_5", counters::name + 5 }, \
+	{ #category "." #name "_6", counters::name + 6 }, \
+	{ #category "." #name "_7", counters::name + 7 }, \
+	{ #category "." #name "_8", counters::name + 8 }, \
+	{ #category "." #name "_9", counters::name + 9 }, \
+	{ #category "." #name "_10", counters::name + 10 }, \
+	{ #category "." #name "_11", counters::name + 11 }, \
+	{ #category "." #name "_12", counters::name + 12 }, \
+	{ #category "." #name "_13", counters::name + 13 }, \
+	{ #category "." #name "_14", counters::name + 14 }, \
+	{ #category "." #name "_15", counters::name + 15 }, \
+	{ #category "." #name "_16", counters::name + 16 }, \
+	{ #category "." #name "_17", counters::name + 17 }, \
+	{ #category "." #name "_18", counters::name + 18 }, \
+	{ #category "." #name "_19", counters::name + 19 }, \
+	{ #category "." #name "_20", counters::name + 20 }, \
+	{ #category "." #name "_21", counters::name + 21 }, \
+	{ #category "." #name "_22", counters::name + 22 }, \
+	{ #category "." #name "_23", counters::name + 23 }, \
+	{ #category "." #name "_24", counters::name + 24 }, \
+	{ #category "." #name "_25", counters::name + 25 }, \
+	{ #category "." #name "_26", counters::name + 26 }, \
+	{ #category "." #name "_27", counters::name + 27 }, \
+	{ #category "." #name "_28", counters::name + 28 }, \
+	{ #category "." #name "_29", counters::name + 29 }, \
+	{ #category "." #name "_30", counters::name + 30 }, \
+	{ #category "." #name "_31", counters::name + 31 }
+	static_assert(counters::num_histogram_buckets == 32
+		, "the HISTOGRAM macro must match num_histogram_buckets");
 	aux::array<stats_metric_impl, counters::num_counters> const metrics({{
 		// ``error_peers`` is the total number of peer disconnects
 		// caused by an error (not initiated by this client) and
@@ -588,8 +624,30 @@ namespace {
 		// this measure the number of tracker announces currently in the
 		// queue
 		METRIC(tracker, num_queued_tracker_announces),
+
+		// log2 histograms of latencies, in microseconds. Each histogram is
+		// made up of 32 metrics, the bucket number is appended to the name.
+		// Bucket n counts samples in the range [2^(n-1), 2^n) microseconds,
+		// bucket 0 counts samples of 0 and the last bucket also counts every
+		// sample larger than its range. i.e. bucket 10 counts samples from
+		// 512 us up to (but not including) 1024 us.
+		//
+		// ``disk_job_queue_time_hist`` is the time disk jobs spend waiting in
+		// the disk job queue and ``disk_job_exec_time_hist`` the time it takes
+		// to execute them.
+		HISTOGRAM(disk, disk_job_queue_time_hist),
+		HISTOGRAM(disk, disk_job_exec_time_hist),
+
+		// the time from a block request being sent to a peer until the block
+		// is received
+		HISTOGRAM(peer, block_request_rtt_hist),
+
+		// the time from the first block of a piece being requested until the
+		// piece passes the hash check
+		HISTOGRAM(picker, piece_download_time_hist),
 		// ... more
 	}});
+#undef HISTOGRAM
 #undef METRIC
 	} // anonymous namespace
 
@@ -601,8 +659,10 @@ namespace {
 		{
 			stats[i].name = metrics[i].name;
 			stats[i].value_index = metrics[i].value_index;
-			stats[i].type = metrics[i].value_index >= counters::num_stats_counters
-				? metric_type_t::gauge : metric_type_t::counter;
+			int const idx = metrics[i].value_index;
+			stats[i].type = idx >= counters::num_stats_counters ? metric_type_t::gauge
+				: idx >= counters::disk_job_queue_time_hist ? metric_type_t::histogram
+				: metric_type_t::counter;
 		}
 		return TORRENT_RVO(stats);
 	}
@@ -390,7 +390,10 @@ namespace {
 		SET(natpmp_lease_duration, 3600, nullptr),
 		SET(min_websocket_announce_interval, 1 * 60, nullptr),
 		SET(webtorrent_connection_timeout, 2 * 60, nullptr),
-		SET(max_webtorrent_offers, 10, nullptr)
+		SET(max_webtorrent_offers, 10, nullptr),
+		SET(dh_key_pool_size, 0, &session_impl::update_dh_key_pool_size),
+		SET(availability_sample_size, 0, nullptr),
+		SET(hydrated_queued_limit, -1, &session_impl::trigger_auto_manage)
 	}});
 	// clang-format on
 
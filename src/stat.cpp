@@ -14,6 +14,10 @@ namespace libtorrent::aux {
 
 void stat_channel::second_tick(int tick_interval_ms)
 {
+	// the common case for idle peers. There's nothing to fold into the
+	// average and nothing left to decay
+	if (m_counter == 0 && m_5_sec_average == 0) return;
+
 	std::int64_t sample = std::int64_t(m_counter) * 1000 / tick_interval_ms;
 	TORRENT_ASSERT(sample >= 0);
 	m_5_sec_average = std::int32_t(std::int64_t(m_5_sec_average) * 4 / 5 + sample / 5);
@@ -61,6 +61,8 @@ see LICENSE file.
 #include "libtorrent/torrent_info.hpp"
 #include "libtorrent/aux_/parse_url.hpp"
 #include "libtorrent/bencode.hpp"
+#include "libtorrent/read_resume_data.hpp"
+#include "libtorrent/write_resume_data.hpp"
 #include "libtorrent/hasher.hpp"
 #include "libtorrent/entry.hpp"
 #include "libtorrent/aux_/peer.hpp"
@@ -274,6 +276,8 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		, m_torrent_initialized(false)
 		, m_outstanding_file_priority(false)
 		, m_complete_sent(false)
+		, m_deferred_init(false)
+		, m_deferred_check_pending(false)
 	{
 		TORRENT_ASSERT_PRECOND(!is_complete(m_part_file_dir));
 		// This is stored in 2 bits
@@ -585,7 +589,7 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		set_need_save_resume(torrent_handle::if_download_progress);
 	}
 
-	void torrent::start()
+	void torrent::start(bool const defer_init)
 	{
 		TORRENT_ASSERT(is_single_thread());
 		TORRENT_ASSERT(m_was_started == false);
@@ -593,6 +597,15 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		m_was_started = true;
 #endif
 
+		// a queued torrent won't need its storage, piece picker or peers until
+		// the auto-manager starts it, which requires its resume data to have
+		// been checked first. The session initializes these a few at a time
+		m_deferred_init = defer_init
+			&& m_torrent_file->is_valid()
+			&& m_paused
+			&& m_auto_managed
+			&& !has_error();
+
 		update_want_tick();
 
 		// Some of these calls may log to the torrent debug log, which requires a
@@ -618,14 +631,19 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 			set_limit_impl(p.upload_limit, peer_connection::upload_channel, false);
 			set_limit_impl(p.download_limit, peer_connection::download_channel, false);
 
-			for (auto const& peer : p.peers)
+			// a deferred torrent picks up its peers once its resume data has
+			// been checked, in on_resume_data_checked()
+			if (!m_deferred_init)
 			{
-				add_peer(peer, peer_info::resume_data);
-			}
+				for (auto const& peer : p.peers)
+				{
+					add_peer(peer, peer_info::resume_data);
+				}
 
-			if (!p.peers.empty())
-			{
-				do_connect_boost();
+				if (!p.peers.empty())
+				{
+					do_connect_boost();
+				}
 			}
 
 			if (!p.root_certificate.empty())
@@ -637,7 +655,7 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 			}
 
 #ifndef TORRENT_DISABLE_LOGGING
-			if (should_log() && !p.peers.empty())
+			if (should_log() && !p.peers.empty() && !m_deferred_init)
 			{
 				std::string str;
 				for (auto const& peer : p.peers)
@@ -697,7 +715,13 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		update_want_scrape();
 		update_state_list();
 
-		if (m_torrent_file->is_valid())
+		if (m_deferred_init)
+		{
+#ifndef TORRENT_DISABLE_LOGGING
+			debug_log("deferring init");
+#endif
+		}
+		else if (m_torrent_file->is_valid())
 		{
 			init();
 		}
@@ -1074,10 +1098,7 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		else if (m_peer_list)
 		{
 			// reset last_connected, to force fast reconnect after leaving upload mode
-			for (auto* pe : *m_peer_list)
-			{
-				pe->last_connected = 0;
-			}
+			m_peer_list->clear_last_connected();
 
 			// send_block_requests on all peers
 			for (auto* p : m_connections)
@@ -1096,6 +1117,71 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		m_peer_list = std::make_unique<peer_list>(m_ses.get_peer_allocator());
 	}
 
+	void torrent::make_dormant()
+	{
+		TORRENT_ASSERT(is_single_thread());
+
+		if (is_dormant()
+			|| !m_paused
+			|| !m_auto_managed
+			|| m_abort
+			|| !m_torrent_initialized
+			|| !m_connections.empty())
+			return;
+
+		// the peers that would be saved in the resume data are the ones worth
+		// keeping, the rest of the peer list is dropped. Only the keys
+		// read_resume_data() needs to parse them back are kept
+		add_torrent_params atp;
+		atp.info_hashes = m_info_hash;
+		write_resume_peers(atp);
+		entry const rd = libtorrent::write_resume_data(atp);
+		entry state(entry::dictionary_t);
+		for (char const* key : {"file-format", "info-hash", "info-hash2"
+			, "peers", "peers6", "banned_peers", "banned_peers6"})
+		{
+			if (entry const* e = rd.find_key(key)) state[key] = *e;
+		}
+		bencode(std::back_inserter(m_dormant_state), state);
+		m_peer_list.reset();
+
+		// the hash picker only tracks outstanding hash requests, it's
+		// recreated from the merkle trees when needed
+		m_hash_picker.reset();
+
+		update_want_peers();
+
+#ifndef TORRENT_DISABLE_LOGGING
+		debug_log("dormant (%d bytes, peers: %d)", int(m_dormant_state.size())
+			, int(atp.peers.size()));
+#endif
+	}
+
+	void torrent::hydrate()
+	{
+		if (!is_dormant()) return;
+
+		error_code ec;
+		add_torrent_params const atp = read_resume_data(m_dormant_state, ec);
+		std::vector<char>().swap(m_dormant_state);
+		TORRENT_ASSERT(!ec);
+
+		for (auto const& p : atp.peers)
+			add_peer(p, peer_info::resume_data);
+
+		for (auto const& p : atp.banned_peers)
+		{
+			torrent_peer* peer = add_peer(p, peer_info::resume_data);
+			if (peer) ban_peer(peer);
+		}
+
+		update_want_peers();
+
+#ifndef TORRENT_DISABLE_LOGGING
+		debug_log("hydrated (peers: %d)", m_peer_list ? m_peer_list->num_peers() : 0);
+#endif
+	}
+
 	void torrent::handle_exception()
 	{
 		try
@@ -1376,6 +1462,12 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 
 		update_gauge();
 
+		// the new picker doesn't know about any of the peers yet. Every peer
+		// is considered for the availability sample again
+		m_num_availability_peers = 0;
+		for (auto* const p : m_connections)
+			p->availability_state(peer_connection::availability_t::undecided);
+
 		for (auto* const p : m_connections)
 		{
 			TORRENT_INCREMENT(m_iterating_connections);
@@ -1936,6 +2028,8 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		debug_log("init torrent: %s", torrent_file().name().c_str());
 #endif
 
+		m_deferred_init = false;
+
 		TORRENT_ASSERT(valid_metadata());
 		TORRENT_ASSERT(m_torrent_file->num_files() > 0);
 		TORRENT_ASSERT(m_torrent_file->total_size() >= 0);
@@ -2198,6 +2292,26 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		return m_outgoing_pids.count(pid) > 0;
 	}
 
+	void torrent::init_deferred()
+	{
+		TORRENT_ASSERT(is_single_thread());
+		TORRENT_ASSERT(m_deferred_init);
+		TORRENT_ASSERT(!m_abort);
+
+		m_deferred_check_pending = true;
+		init();
+
+		// if init() failed, no resume data check was issued
+		if (!m_torrent_initialized) deferred_check_done();
+	}
+
+	void torrent::deferred_check_done()
+	{
+		if (!m_deferred_check_pending) return;
+		m_deferred_check_pending = false;
+		m_ses.deferred_init_done();
+	}
+
 	void torrent::on_resume_data_checked(status_t const status
 		, storage_error const& error) try
 	{
@@ -2206,6 +2320,8 @@ aux::vector<download_priority_t, piece_index_t> file_to_piece_prio(
 		m_outstanding_check_files = false;
 #endif
 
+		deferred_check_done();
+
 		// when applying some of the resume data to the torrent, we will
 		// trigger calls that set m_need_save_resume_data, even though we're
 		// just applying the state of the resume data we loaded with. We don't
@@ -4324,7 +4440,8 @@ namespace {
 
 	// fills in total_wanted, total_wanted_done and total_done
 // TODO: 3 this could probably be pulled out into a free function
-	void torrent::bytes_done(torrent_status& st, status_flags_t const flags) const
+	template <typename Status>
+	void torrent::bytes_done(Status& st, status_flags_t const flags) const
 	{
 		INVARIANT_CHECK;
 
@@ -4515,13 +4632,57 @@ namespace {
 		// when we care about suggest mode, we keep the piece picker
 		// around to track piece availability
 		need_picker();
-		int const peers = std::max(num_peers(), 1);
+		int const peers = std::max(
+			settings().get_int(settings_pack::availability_sample_size) > 0
+			? int(m_num_availability_peers) : num_peers(), 1);
 		int const availability = m_picker->get_availability(index) * 100 / peers;
 
 		m_suggest_pieces.add_piece(index, availability
 			, settings().get_int(settings_pack::max_suggest_pieces));
 	}
 
+	void torrent::update_cached_pieces()
+	{
+		TORRENT_ASSERT(is_single_thread());
+		m_last_cached_pieces_update = aux::time_now32();
+
+		if (!m_storage) return;
+		m_cached_pieces = m_ses.disk_thread().cached_pieces(m_storage);
+
+		// if the disk I/O subsystem doesn't know which pieces are in memory, we
+		// keep suggesting the pieces we recently read instead
+		if (m_cached_pieces.empty() || !has_picker()) return;
+
+		std::vector<std::pair<int, piece_index_t>> pieces;
+		m_cached_pieces.for_each_set_bit([&](piece_index_t const p)
+		{
+			// pages of a piece we're still downloading may be in memory too
+			if (have_piece(p))
+				pieces.emplace_back(m_picker->get_availability(p), p);
+			return false;
+		});
+
+		// suggest the rarest of the pieces in memory
+		int const num = std::min(int(pieces.size())
+			, settings().get_int(settings_pack::max_suggest_pieces));
+		std::partial_sort(pieces.begin(), pieces.begin() + num, pieces.end());
+
+		// the highest priority piece goes last
+		std::vector<piece_index_t> suggest;
+		suggest.reserve(std::size_t(num));
+		for (int i = num - 1; i >= 0; --i)
+			suggest.push_back(pieces[std::size_t(i)].second);
+		m_suggest_pieces.set_pieces(suggest);
+
+		// peers are otherwise only sent suggestions as they are unchoked
+		for (auto* p : m_connections)
+		{
+			TORRENT_INCREMENT(m_iterating_connections);
+			if (p->is_choked() || p->is_disconnecting()) continue;
+			p->send_piece_suggestions(2);
+		}
+	}
+
 	// this is called when either:
 	// * we have completely downloaded piece 'index' and its hash has been verified.
 	// * during initial file check when we find a piece whose hash is correct
@@ -4810,6 +4971,13 @@ namespace {
 
 		inc_stats_counter(counters::num_piece_passed);
 
+		time_point const download_start = m_picker->download_start(index);
+		if (download_start != time_point{})
+		{
+			m_ses.stats_counters().add_histogram_sample(counters::piece_download_time_hist
+				, total_microseconds(clock_type::now() - download_start));
+		}
+
 		if (settings().get_int(settings_pack::suggest_mode)
 			== settings_pack::suggest_read_cache)
 		{
@@ -5160,10 +5328,69 @@ namespace {
 	}
 	catch (...) { handle_exception(); }
 
-	void torrent::peer_has(piece_index_t const index, peer_connection const* peer)
+	bool torrent::count_availability(peer_connection* const p, bool const seed)
+	{
+		TORRENT_ASSERT(has_picker());
+		using availability_t = peer_connection::availability_t;
+		switch (p->availability_state())
+		{
+			case availability_t::counted: return true;
+			case availability_t::uncounted: return false;
+			case availability_t::undecided: break;
+		}
+
+		// seeds are cheap to count (see piece_picker::inc_refcount_all()), so
+		// they are always counted, even when the sample is full
+		int const sample = settings().get_int(settings_pack::availability_sample_size);
+		if (sample > 0 && !seed && m_num_availability_peers >= sample)
+		{
+			p->availability_state(availability_t::uncounted);
+			m_picker->inc_uncounted_peer();
+			return false;
+		}
+
+		p->availability_state(availability_t::counted);
+		++m_num_availability_peers;
+		return true;
+	}
+
+	void torrent::remove_availability(peer_connection* const p)
+	{
+		using availability_t = peer_connection::availability_t;
+		auto const state = p->availability_state();
+		p->availability_state(availability_t::undecided);
+
+		if (state == availability_t::undecided) return;
+		if (state == availability_t::counted)
+		{
+			TORRENT_ASSERT(m_num_availability_peers > 0);
+			--m_num_availability_peers;
+		}
+
+		if (!has_picker()) return;
+
+		torrent_peer* pp = p->peer_info_struct();
+		if (state == availability_t::uncounted)
+		{
+			m_picker->dec_uncounted_peer();
+		}
+		else if (p->is_seed())
+		{
+			m_picker->dec_refcount_all(pp);
+		}
+		else
+		{
+			auto const& pieces = p->get_bitfield();
+			TORRENT_ASSERT(pieces.count() <= pieces.size());
+			m_picker->dec_refcount(pieces, pp);
+		}
+	}
+
+	void torrent::peer_has(piece_index_t const index, peer_connection* const peer)
 	{
 		if (has_picker())
 		{
+			if (!count_availability(peer, false)) return;
 			torrent_peer* pp = peer->peer_info_struct();
 			m_picker->inc_refcount(index, pp);
 		}
@@ -5175,11 +5402,13 @@ namespace {
 
 	// when we get a bitfield message, this is called for that piece
 	void torrent::peer_has(typed_bitfield<piece_index_t> const& bits
-		, peer_connection const* peer)
+		, peer_connection* const peer)
 	{
 		if (has_picker())
 		{
 			TORRENT_ASSERT(bits.size() == torrent_file().num_pieces());
+			if (bits.none_set()) return;
+			if (!count_availability(peer, bits.all_set())) return;
 			torrent_peer* pp = peer->peer_info_struct();
 			m_picker->inc_refcount(bits, pp);
 		}
@@ -5189,10 +5418,11 @@ namespace {
 		}
 	}
 
-	void torrent::peer_has_all(peer_connection const* peer)
+	void torrent::peer_has_all(peer_connection* const peer)
 	{
 		if (has_picker())
 		{
+			if (!count_availability(peer, true)) return;
 			torrent_peer* pp = peer->peer_info_struct();
 			m_picker->inc_refcount_all(pp);
 		}
@@ -5208,6 +5438,8 @@ namespace {
 		if (has_picker())
 		{
 			TORRENT_ASSERT(bits.size() == torrent_file().num_pieces());
+			if (peer->availability_state() != peer_connection::availability_t::counted)
+				return;
 			torrent_peer* pp = peer->peer_info_struct();
 			m_picker->dec_refcount(bits, pp);
 		}
@@ -5221,6 +5453,8 @@ namespace {
 	{
 		if (m_picker)
 		{
+			if (peer->availability_state() != peer_connection::availability_t::counted)
+				return;
 			torrent_peer* pp = peer->peer_info_struct();
 			m_picker->dec_refcount(index, pp);
 		}
@@ -5249,6 +5483,10 @@ namespace {
 		m_graceful_pause_mode = false;
 		m_auto_managed = false;
 		m_state_subscription = false;
+		m_deferred_init = false;
+		// don't hold up the next deferred torrent waiting for our resume data
+		// check to complete
+		deferred_check_done();
 		for (torrent_list_index_t i{}; i != m_links.end_index(); ++i)
 		{
 			if (!m_links[i].in_list()) continue;
@@ -5743,13 +5981,40 @@ namespace {
 		TORRENT_ASSERT(valid_metadata());
 		if (!has_picker())
 		{
-			avail.clear();
+			if (m_have_all)
+				seed_piece_availability(avail);
+			else
+				avail.clear();
 			return;
 		}
 
 		m_picker->get_availability(avail);
 	}
 
+	void torrent::seed_piece_availability(aux::vector<int, piece_index_t>& avail) const
+	{
+		avail.clear();
+		avail.resize(m_torrent_file->num_pieces(), 0);
+
+		int seeds = 0;
+		for (auto const* p : m_connections)
+		{
+			if (p->is_seed())
+			{
+				++seeds;
+				continue;
+			}
+			p->get_bitfield().for_each_set_bit([&](piece_index_t const i)
+			{
+				++avail[i];
+				return false;
+			});
+		}
+
+		if (seeds > 0)
+			for (auto& a : avail) a += seeds;
+	}
+
 	void torrent::set_piece_priority(piece_index_t const index
 		, download_priority_t const priority)
 	{
@@ -5774,10 +6039,14 @@ namespace {
 		need_picker();
 
 		bool const was_finished = is_finished();
+		bool const changed = m_picker->piece_priority(index) != priority;
 		bool const filter_updated = m_picker->set_piece_priority(index, priority);
 
 		update_gauge();
 
+		// we need to save this new state
+		if (changed) set_need_save_resume(torrent_handle::if_config_changed);
+
 		if (filter_updated)
 		{
 			update_peer_interest(was_finished);
@@ -5817,6 +6086,7 @@ namespace {
 		need_picker();
 
 		bool filter_updated = false;
+		bool changed = false;
 		bool const was_finished = is_finished();
 		for (auto const& p : pieces)
 		{
@@ -5835,16 +6105,16 @@ namespace {
 				continue;
 			}
 
+			changed |= m_picker->piece_priority(p.first) != p.second;
 			filter_updated |= m_picker->set_piece_priority(p.first, p.second);
 		}
 		update_gauge();
-		if (filter_updated)
-		{
-			// we need to save this new state
-			set_need_save_resume(torrent_handle::if_config_changed);
 
+		// we need to save this new state
+		if (changed) set_need_save_resume(torrent_handle::if_config_changed);
+
+		if (filter_updated)
 			update_peer_interest(was_finished);
-		}
 
 		state_updated();
 	}
@@ -5869,23 +6139,25 @@ namespace {
 
 		piece_index_t index(0);
 		bool filter_updated = false;
+		bool changed = false;
 		bool const was_finished = is_finished();
 		for (auto prio : pieces)
 		{
 			static_assert(std::is_unsigned<decltype(prio)::underlying_type>::value
 				, "we need assert prio >= dont_download");
 			TORRENT_ASSERT(prio <= top_priority);
+			changed |= m_picker->piece_priority(index) != prio;
 			filter_updated |= m_picker->set_piece_priority(index, prio);
 			++index;
 		}
 		update_gauge();
 		update_want_tick();
 
+		// we need to save this new state
+		if (changed) set_need_save_resume(torrent_handle::if_config_changed);
+
 		if (filter_updated)
 		{
-			// we need to save this new state
-			set_need_save_resume(torrent_handle::if_config_changed);
-
 			update_peer_interest(was_finished);
 #ifndef TORRENT_DISABLE_STREAMING
 			remove_time_critical_pieces(pieces);
@@ -6532,19 +6804,7 @@ namespace {
 			TORRENT_ASSERT(p->associated_torrent().lock().get() == nullptr
 				|| p->associated_torrent().lock().get() == this);
 
-			if (has_picker())
-			{
-				if (p->is_seed())
-				{
-					m_picker->dec_refcount_all(pp);
-				}
-				else
-				{
-					auto const& pieces = p->get_bitfield();
-					TORRENT_ASSERT(pieces.count() <= pieces.size());
-					m_picker->dec_refcount(pieces, pp);
-				}
-			}
+			remove_availability(p.get());
 		}
 
 		if (!p->is_choked() && !p->ignore_unchoke_slots())
@@ -7377,6 +7637,63 @@ namespace {
 		m_trackers.enable_all();
 	}
 
+	void torrent::write_resume_peers(add_torrent_params& ret) const
+	{
+		std::vector<torrent_peer const*> deferred_peers;
+		if (m_peer_list)
+		{
+			for (auto* p : *m_peer_list)
+			{
+#if TORRENT_USE_I2P
+				if (p->is_i2p_addr) continue;
+#endif
+				if (p->banned)
+				{
+					ret.banned_peers.push_back(p->ip());
+					continue;
+				}
+
+				// we cannot save remote connection
+				// since we don't know their listen port
+				// unless they gave us their listen port
+				// through the extension handshake
+				// so, if the peer is not connectable (i.e. we
+				// don't know its listen port) or if it has
+				// been banned, don't save it.
+				if (!p->connectable) continue;
+
+				// don't save peers that don't work
+				if (int(p->failcount) > 0) continue;
+
+				// don't save peers that appear to send corrupt data
+				if (int(p->trust_points) < 0) continue;
+
+				if (p->last_connected == 0)
+				{
+					// we haven't connected to this peer. It might still
+					// be useful to save it, but only save it if we
+					// don't have enough peers that we actually did connect to
+					if (int(deferred_peers.size()) < 100)
+						deferred_peers.push_back(p);
+					continue;
+				}
+
+				ret.peers.push_back(p->ip());
+			}
+		}
+
+		// if we didn't save 100 peers, fill in with second choice peers
+		if (int(ret.peers.size()) < 100)
+		{
+			aux::random_shuffle(deferred_peers);
+			for (auto const* p : deferred_peers)
+			{
+				ret.peers.push_back(p->ip());
+				if (int(ret.peers.size()) >= 100) break;
+			}
+		}
+	}
+
 	void torrent::write_resume_data(resume_data_flags_t const flags, add_torrent_params& ret) const
 	{
 		ret.version = LIBTORRENT_VERSION_NUM;
@@ -7506,60 +7823,7 @@ namespace {
 		if (valid_metadata())
 			ret.renamed_files = m_renamed_files.export_filenames(m_torrent_file->layout());
 
-		// write local peers
-		std::vector<torrent_peer const*> deferred_peers;
-		if (m_peer_list)
-		{
-			for (auto* p : *m_peer_list)
-			{
-#if TORRENT_USE_I2P
-				if (p->is_i2p_addr) continue;
-#endif
-				if (p->banned)
-				{
-					ret.banned_peers.push_back(p->ip());
-					continue;
-				}
-
-				// we cannot save remote connection
-				// since we don't know their listen port
-				// unless they gave us their listen port
-				// through the extension handshake
-				// so, if the peer is not connectable (i.e. we
-				// don't know its listen port) or if it has
-				// been banned, don't save it.
-				if (!p->connectable) continue;
-
-				// don't save peers that don't work
-				if (int(p->failcount) > 0) continue;
-
-				// don't save peers that appear to send corrupt data
-				if (int(p->trust_points) < 0) continue;
-
-				if (p->last_connected == 0)
-				{
-					// we haven't connected to this peer. It might still
-					// be useful to save it, but only save it if we
-					// don't have enough peers that we actually did connect to
-					if (int(deferred_peers.size()) < 100)
-						deferred_peers.push_back(p);
-					continue;
-				}
-
-				ret.peers.push_back(p->ip());
-			}
-		}
-
-		// if we didn't save 100 peers, fill in with second choice peers
-		if (int(ret.peers.size()) < 100)
-		{
-			aux::random_shuffle(deferred_peers);
-			for (auto const* p : deferred_peers)
-			{
-				ret.peers.push_back(p->ip());
-				if (int(ret.peers.size()) >= 100) break;
-			}
-		}
+		write_resume_peers(ret);
 
 		ret.upload_limit = upload_limit();
 		ret.download_limit = download_limit();
@@ -7640,6 +7904,117 @@ namespace {
 				}
 			}
 		}
+
+		if (is_dormant())
+		{
+			// the peers of a dormant torrent are still encoded, and the ones
+			// we may have picked up since are all in ret already
+			error_code ec;
+			add_torrent_params const atp = read_resume_data(m_dormant_state, ec);
+			ret.peers.insert(ret.peers.end(), atp.peers.begin(), atp.peers.end());
+			ret.banned_peers.insert(ret.banned_peers.end()
+				, atp.banned_peers.begin(), atp.banned_peers.end());
+		}
+
+		if (m_deferred_init && m_add_torrent_params)
+		{
+			// we haven't been initialized yet, so none of the piece state or
+			// peers in the resume data we were added with has been loaded.
+			// It's still the most recent state, pass it on as-is
+			add_torrent_params const& p = *m_add_torrent_params;
+			ret.have_pieces = p.have_pieces;
+			ret.verified_pieces = p.verified_pieces;
+			ret.unfinished_pieces = p.unfinished_pieces;
+			if (!has_picker()) ret.piece_priorities = p.piece_priorities;
+			ret.peers = p.peers;
+			ret.banned_peers = p.banned_peers;
+		}
+	}
+
+	void torrent::make_resume_delta(add_torrent_params& ret
+		, resume_data_flags_t const changed)
+	{
+		// a delta can only add pieces. Without a base to compare to, or if we
+		// lost pieces since the last save (e.g. by a failed hash check or
+		// force_recheck()), this has to be a full save
+		auto& base = m_resume_delta_base;
+		int const num_bytes = ret.have_pieces.num_bytes();
+		char* have = ret.have_pieces.data();
+		char* saved = base.data();
+		bool delta = base.size() == ret.have_pieces.size();
+		for (int i = 0; delta && i < num_bytes; ++i)
+			if (saved[i] & ~have[i]) delta = false;
+
+		if (!delta)
+		{
+			base = ret.have_pieces;
+			return;
+		}
+
+		// only keep the pieces we didn't have at the last save
+		for (int i = 0; i < num_bytes; ++i)
+		{
+			char const added = char(have[i] & ~saved[i]);
+			saved[i] |= added;
+			have[i] = added;
+		}
+
+		// a file's merkle tree is only saved again once we have completed
+		// more of its pieces
+		if (!ret.merkle_trees.empty() && valid_metadata())
+		{
+			file_storage const& fs = m_torrent_file->layout();
+			bool any_tree = false;
+			for (auto const f : ret.merkle_trees.range())
+			{
+				if (ret.merkle_trees[f].empty()) continue;
+				bool dirty = false;
+				if (f < fs.end_file() && fs.file_size(f) > 0)
+				{
+					piece_index_t const last = fs.last_piece_index_at_file(f);
+					for (piece_index_t p = fs.piece_index_at_file(f); p <= last; ++p)
+					{
+						if (!ret.have_pieces.get_bit(p)) continue;
+						dirty = true;
+						break;
+					}
+				}
+				if (dirty)
+				{
+					any_tree = true;
+					continue;
+				}
+				ret.merkle_trees[f].clear();
+				if (f < ret.merkle_tree_mask.end_index())
+					ret.merkle_tree_mask[f].clear();
+				if (f < ret.verified_leaf_hashes.end_index())
+					ret.verified_leaf_hashes[f].clear();
+			}
+			if (!any_tree)
+			{
+				ret.merkle_trees.clear();
+				ret.merkle_tree_mask.clear();
+				ret.verified_leaf_hashes.clear();
+			}
+		}
+
+		if (changed & torrent_handle::if_config_changed)
+		{
+			// an empty list means the priorities didn't change, so if they
+			// changed back to the defaults, that has to be spelled out
+			if (ret.piece_priorities.empty() && valid_metadata())
+			{
+				ret.piece_priorities.assign(
+					std::size_t(m_torrent_file->num_pieces()), default_priority);
+			}
+		}
+		else
+		{
+			ret.piece_priorities.clear();
+			ret.file_priorities.clear();
+		}
+
+		ret.resume_delta = true;
 	}
 
 #if TORRENT_ABI_VERSION == 1
@@ -9838,16 +10213,6 @@ namespace {
 		}
 	}
 
-	namespace {
-
-	std::uint16_t clamped_subtract_u16(int const a, int const b)
-	{
-		if (a < b) return 0;
-		return std::uint16_t(a - b);
-	}
-
-	} // anonymous namespace
-
 	// this is called every time the session timer takes a step back. Since the
 	// session time is meant to fit in 16 bits, it only covers a range of
 	// about 18 hours. This means every few hours the whole epoch of this
@@ -9858,12 +10223,7 @@ namespace {
 	void torrent::step_session_time(int const seconds)
 	{
 		if (!m_peer_list) return;
-		for (auto* pe : *m_peer_list)
-		{
-			pe->last_optimistically_unchoked
-				= clamped_subtract_u16(pe->last_optimistically_unchoked, seconds);
-			pe->last_connected = clamped_subtract_u16(pe->last_connected, seconds);
-		}
+		m_peer_list->step_session_time(seconds);
 	}
 
 	// the higher seed rank, the more important to seed
@@ -9965,6 +10325,7 @@ namespace {
 			return;
 		}
 
+		resume_data_flags_t const changed = m_need_save_resume_data;
 		m_need_save_resume_data = resume_data_flags_t{};
 		state_updated();
 
@@ -9978,6 +10339,10 @@ namespace {
 
 		add_torrent_params atp;
 		write_resume_data(flags, atp);
+		if (flags & torrent_handle::save_delta)
+			make_resume_delta(atp, changed);
+		else if (!m_resume_delta_base.empty())
+			m_resume_delta_base = atp.have_pieces;
 		alerts().emplace_alert<save_resume_data_alert>(std::move(atp), get_handle());
 	}
 
@@ -10319,6 +10684,11 @@ namespace {
 			return;
 		}
 
+		// the torrent is being started before the session got to initializing
+		// it. Don't make it wait for its turn
+		if (m_deferred_init) init();
+		hydrate();
+
 		// is_paused() already reflects the new state (the caller cleared
 		// m_paused before calling us), so flush/re-anchor the timers now,
 		// regardless of whether an extension below defers the rest of the
@@ -10743,6 +11113,19 @@ namespace {
 
 		maybe_connect_web_seeds();
 
+		// ---- CACHE-AWARE SUGGESTIONS ----
+
+		if (settings().get_int(settings_pack::suggest_mode)
+			== settings_pack::suggest_read_cache)
+		{
+			if (aux::time_now32() - m_last_cached_pieces_update >= seconds32(10))
+				update_cached_pieces();
+		}
+		else if (!m_cached_pieces.empty())
+		{
+			m_cached_pieces.clear();
+		}
+
 		m_swarm_last_seen_complete = m_last_seen_complete;
 		for (auto* p : m_connections)
 		{
@@ -11204,6 +11587,42 @@ namespace {
 			interesting_blocks.emplace_back(piece, block.index);
 	}
 
+	// returns true if every block of the piece that's still outstanding is
+	// expected to arrive before the deadline, based on the download queue
+	// time of the peer it was (last) requested from. In that case there's no
+	// point in sending duplicate requests for it, the bandwidth is better
+	// spent on the next piece
+	bool outstanding_blocks_meet_deadline(piece_picker const* picker
+		, piece_picker::downloading_piece const& pi
+		, time_point const deadline
+		, time_point const now)
+	{
+		for (auto const& info : picker->blocks_for_piece(pi))
+		{
+			if (info.state != piece_picker::block_info::state_requested)
+				continue;
+
+			if (info.peer == nullptr || info.peer->connection == nullptr)
+				return false;
+
+			auto const* peer = static_cast<peer_connection const*>(info.peer->connection);
+			if (now + peer->download_queue_time() > deadline)
+				return false;
+		}
+		return true;
+	}
+
+	// inserts p into peers, which is sorted by download queue time
+	void insert_by_queue_time(std::vector<peer_connection*>& peers
+		, peer_connection* p)
+	{
+		time_duration const t = p->download_queue_time();
+		auto const it = std::upper_bound(peers.begin(), peers.end(), t
+			, [] (time_duration const lhs, peer_connection const* rhs)
+			{ return lhs < rhs->download_queue_time(); });
+		peers.insert(it, p);
+	}
+
 	void pick_time_critical_block(std::vector<peer_connection*>& peers
 		, std::vector<peer_connection*>& ignore_peers
 		, std::set<peer_connection*>& peers_with_requests
@@ -11410,16 +11829,20 @@ namespace {
 		// blocks from. For instance, peers that have choked us, peers that are
 		// on parole (i.e. they are believed to have sent us bad data), peers
 		// that are being disconnected, in upload mode etc.
-		std::remove_copy_if(m_connections.begin(), m_connections.end()
-			, std::back_inserter(peers), [] (peer_connection* p)
-			{ return !p->can_request_time_critical(); });
-
 		// sort by the time we believe it will take this peer to send us all
 		// blocks we've requested from it. The shorter time, the better candidate
-		// it is to request a time critical block from.
-		std::sort(peers.begin(), peers.end()
-			, [] (peer_connection const* lhs, peer_connection const* rhs)
-			{ return lhs->download_queue_time(16*1024) < rhs->download_queue_time(16*1024); });
+		// it is to request a time critical block from. The queue time is
+		// computed once per peer, rather than in every comparison
+		std::vector<std::pair<time_duration, peer_connection*>> sorted_peers;
+		sorted_peers.reserve(m_connections.size());
+		for (auto* p : m_connections)
+		{
+			if (!p->can_request_time_critical()) continue;
+			sorted_peers.emplace_back(p->download_queue_time(16*1024), p);
+		}
+		std::sort(sorted_peers.begin(), sorted_peers.end()
+			, [] (auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+		for (auto const& p : sorted_peers) peers.push_back(p.second);
 
 		// remove the bottom 10% of peers from the candidate set.
 		// this is just to remove outliers that might stall downloads
@@ -11526,6 +11949,18 @@ namespace {
 					continue;
 				}
 
+				// the piece looks stalled, but if all outstanding requests are
+				// still expected to make it in time for the deadline, duplicate
+				// requests would only waste bandwidth
+				if (outstanding_blocks_meet_deadline(m_picker.get(), pi, i.deadline, now))
+				{
+#if TORRENT_DEBUG_STREAMING > 1
+					std::printf("skipping %d (full) outstanding requests on time\n"
+						, i.piece);
+#endif
+					continue;
+				}
+
 				// it's been too long since we requested the last block from
 				// this piece. Allow re-requesting blocks from this piece
 #if TORRENT_DEBUG_STREAMING > 1
@@ -11546,14 +11981,8 @@ namespace {
 			// put back the peers we ignored into the peer list for the next piece
 			if (!ignore_peers.empty())
 			{
-				peers.insert(peers.begin(), ignore_peers.begin(), ignore_peers.end());
+				for (auto* p : ignore_peers) insert_by_queue_time(peers, p);
 				ignore_peers.clear();
-
-				// TODO: instead of resorting the whole list, insert the peers
-				// directly into the right place
-				std::sort(peers.begin(), peers.end()
-					, [] (peer_connection const* lhs, peer_connection const* rhs)
-					{ return lhs->download_queue_time(16*1024) < rhs->download_queue_time(16*1024); });
 			}
 
 			// if this peer's download time exceeds 2 seconds, we're done.
@@ -12278,6 +12707,134 @@ namespace {
 		m_ses.alerts().emplace_alert<state_update_alert>(std::move(s));
 	}
 
+	bool torrent::status_delta(torrent_status_delta* d, status_field_t const fields)
+	{
+		INVARIANT_CHECK;
+
+		// fields requested now, that weren't requested last time, are always
+		// reported
+		status_field_t const prev_fields = m_last_status_delta
+			? m_last_status_delta->changed : status_field_t{};
+		if (!m_last_status_delta)
+			m_last_status_delta = std::make_unique<torrent_status_delta>();
+		torrent_status_delta& last = *m_last_status_delta;
+
+		d->info_hashes = info_hash();
+		d->changed = {};
+
+		auto report = [&](status_field_t const f, auto const cur, auto& prev, auto& out)
+		{
+			if ((prev_fields & f) && cur == prev) return;
+			prev = cur;
+			out = cur;
+			d->changed |= f;
+		};
+
+		if (fields & status_field::state)
+		{
+			auto const s = valid_metadata()
+				? static_cast<torrent_status::state_t>(m_state)
+				: torrent_status::downloading_metadata;
+			report(status_field::state, s, last.state, d->state);
+		}
+
+		if (fields & status_field::flags)
+			report(status_field::flags, this->flags(), last.flags, d->flags);
+
+		if (fields & status_field::progress)
+		{
+			torrent_status_delta cur;
+			bytes_done(cur, {});
+			if (!valid_metadata() || m_state == torrent_status::checking_files)
+				cur.progress_ppm = m_progress_ppm;
+			else if (cur.total_wanted == 0)
+				cur.progress_ppm = 1000000;
+			else
+				cur.progress_ppm = int(cur.total_wanted_done * 1000000 / cur.total_wanted);
+
+			if (!(prev_fields & status_field::progress)
+				|| cur.progress_ppm != last.progress_ppm
+				|| cur.total_done != last.total_done
+				|| cur.total_wanted_done != last.total_wanted_done
+				|| cur.total_wanted != last.total_wanted
+				|| cur.total != last.total)
+			{
+				last.progress_ppm = d->progress_ppm = cur.progress_ppm;
+				last.total_done = d->total_done = cur.total_done;
+				last.total_wanted_done = d->total_wanted_done = cur.total_wanted_done;
+				last.total_wanted = d->total_wanted = cur.total_wanted;
+				last.total = d->total = cur.total;
+				d->changed |= status_field::progress;
+			}
+		}
+
+		if (fields & status_field::rates)
+		{
+			int const down = m_stat.download_payload_rate();
+			int const up = m_stat.upload_payload_rate();
+			if (!(prev_fields & status_field::rates)
+				|| down != last.download_payload_rate
+				|| up != last.upload_payload_rate)
+			{
+				last.download_payload_rate = d->download_payload_rate = down;
+				last.upload_payload_rate = d->upload_payload_rate = up;
+				d->changed |= status_field::rates;
+			}
+		}
+
+		if (fields & status_field::transfer)
+		{
+			if (!(prev_fields & status_field::transfer)
+				|| m_total_downloaded != last.all_time_download
+				|| m_total_uploaded != last.all_time_upload)
+			{
+				last.all_time_download = d->all_time_download = m_total_downloaded;
+				last.all_time_upload = d->all_time_upload = m_total_uploaded;
+				d->changed |= status_field::transfer;
+			}
+		}
+
+		if (fields & status_field::peers)
+		{
+			int const peers = num_peers() - m_num_connecting;
+			int const seeds = num_seeds();
+			if (!(prev_fields & status_field::peers)
+				|| peers != last.num_peers
+				|| seeds != last.num_seeds)
+			{
+				last.num_peers = d->num_peers = peers;
+				last.num_seeds = d->num_seeds = seeds;
+				d->changed |= status_field::peers;
+			}
+		}
+
+		if (fields & status_field::swarm)
+		{
+			int const complete = (m_complete == 0xffffff) ? -1 : int(m_complete);
+			int const incomplete = (m_incomplete == 0xffffff) ? -1 : int(m_incomplete);
+			if (!(prev_fields & status_field::swarm)
+				|| complete != last.num_complete
+				|| incomplete != last.num_incomplete)
+			{
+				last.num_complete = d->num_complete = complete;
+				last.num_incomplete = d->num_incomplete = incomplete;
+				d->changed |= status_field::swarm;
+			}
+		}
+
+		if (fields & status_field::queue_position)
+		{
+			report(status_field::queue_position, queue_position()
+				, last.queue_position, d->queue_position);
+		}
+
+		if (fields & status_field::error)
+			report(status_field::error, bool(m_error), last.has_error, d->has_error);
+
+		last.changed = fields;
+		return bool(d->changed);
+	}
+
 	void torrent::status(torrent_status* st, status_flags_t const flags)
 	{
 		INVARIANT_CHECK;
@@ -12584,6 +13141,24 @@ namespace {
 #else
 			st->distributed_copies = float(st->distributed_full_copies)
 				+ float(st->distributed_fraction) / 1000;
+#endif
+		}
+		else if ((flags & torrent_handle::query_distributed_copies)
+			&& m_have_all && valid_metadata())
+		{
+			// we don't keep a piece picker for torrents we're seeding. Compute
+			// the availability on demand instead
+			aux::vector<int, piece_index_t> avail;
+			seed_piece_availability(avail);
+			std::tie(st->distributed_full_copies, st->distributed_fraction) =
+				aux::distributed_copies(avail);
+			// take ourself into account
+			++st->distributed_full_copies;
+#if TORRENT_NO_FPU
+			st->distributed_copies = -1.f;
+#else
+			st->distributed_copies = float(st->distributed_full_copies)
+				+ float(st->distributed_fraction) / 1000;
 #endif
 		}
 		else
@@ -30,6 +30,7 @@ see LICENSE file.
 #include "libtorrent/aux_/session_call.hpp"
 #include "libtorrent/aux_/throw.hpp"
 #include "libtorrent/aux_/invariant_check.hpp"
+#include "libtorrent/aux_/handler_trace.hpp"
 #include "libtorrent/announce_entry.hpp"
 #include "libtorrent/write_resume_data.hpp"
 #include "libtorrent/torrent_flags.hpp"
@@ -77,6 +78,7 @@ namespace libtorrent {
 		auto& ses = static_cast<session_impl&>(t->session());
 		dispatch(ses.get_context(), std::bind([t, f, &ses](auto&&... args) mutable
 		{
+			TORRENT_TRACE_SCOPE("torrent_handle call");
 #ifndef BOOST_NO_EXCEPTIONS
 			try {
 #endif
@@ -109,6 +111,7 @@ namespace libtorrent {
 		std::exception_ptr ex;
 		dispatch(ses.get_context(), std::bind([t, f, &done, &ses, &ex](auto&&... args) mutable
 		{
+			TORRENT_TRACE_SCOPE("torrent_handle call");
 #ifndef BOOST_NO_EXCEPTIONS
 			try {
 #endif
@@ -145,6 +148,7 @@ namespace libtorrent {
 		std::exception_ptr ex;
 		dispatch(ses.get_context(), std::bind([t, f, &r, &done, &ses, &ex](auto&&... args) mutable
 		{
+			TORRENT_TRACE_SCOPE("torrent_handle call");
 #ifndef BOOST_NO_EXCEPTIONS
 			try {
 #endif
@@ -159,6 +159,7 @@ namespace libtorrent::aux {
 		, supports_holepunch(false)
 		, web_seed(false)
 		, protocol_v2(false)
+		, in_connect_queue(false)
 	{}
 
 	std::uint32_t torrent_peer::rank(aux::external_ip const& external, int external_port) const
@@ -190,8 +190,22 @@ namespace {
 		entry::list_type& url_list = ret["url-list"].list();
 		std::copy(atp.url_seeds.begin(), atp.url_seeds.end(), std::back_inserter(url_list));
 
-		// write have bitmask
-		if (!atp.have_pieces.empty())
+		if (atp.resume_delta)
+			ret["delta"] = 1;
+
+		// write have bitmask. The pieces in a delta are usually few, in which
+		// case a list of their indices is more compact than the bitmask
+		if (atp.resume_delta && atp.have_pieces.count() * 4 < atp.have_pieces.num_bytes())
+		{
+			auto& new_pieces = ret["new-pieces"].string();
+			std::back_insert_iterator<entry::string_type> ptr(new_pieces);
+			atp.have_pieces.for_each_set_bit([&](piece_index_t const i)
+			{
+				aux::write_uint32(static_cast<int>(i), ptr);
+				return false;
+			});
+		}
+		else if (!atp.have_pieces.empty())
 		{
 			ret["pieces"] = to_string(atp.have_pieces);
 		}
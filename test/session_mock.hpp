@@ -26,6 +26,7 @@ see LICENSE file.
 
 #if TORRENT_USE_SSL
 #include "libtorrent/aux_/ssl.hpp"
+#include "libtorrent/aux_/pe_crypto.hpp"
 #endif
 
 #include "libtorrent/io_context.hpp"
@@ -110,6 +111,7 @@ struct session_mock : aux::session_interface
 	void prioritize_connections(std::weak_ptr<aux::torrent>) override {}
 
 	void trigger_auto_manage() override {}
+	void deferred_init_done() override {}
 
 	void apply_settings_pack(std::shared_ptr<settings_pack>) override {}
 	aux::session_settings const& settings() const override { return _session_settings; }
@@ -156,7 +158,9 @@ struct session_mock : aux::session_interface
 #endif
 
 #ifndef TORRENT_DISABLE_ENCRYPTION
-	aux::torrent const* find_encrypted_torrent(sha1_hash const&, sha1_hash const&) override { return nullptr; }
+	aux::torrent const* find_encrypted_torrent(sha1_hash const&, sha1_hash const&, protocol_version&) override { return nullptr; }
+	std::unique_ptr<aux::dh_key_exchange> take_dh_key() override
+	{ return std::make_unique<aux::dh_key_exchange>(); }
 #endif
 
 #if TORRENT_USE_I2P
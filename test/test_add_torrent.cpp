@@ -20,6 +20,8 @@ see LICENSE file.
 #include "libtorrent/load_torrent.hpp"
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace {
 
@@ -40,6 +42,7 @@ add_torrent_test_flag_t const set_invalid_info_hash = 6_bit;
 #endif
 add_torrent_test_flag_t const set_invalid_info_hash_v1 = 7_bit;
 add_torrent_test_flag_t const set_invalid_info_hash_v2 = 8_bit;
+add_torrent_test_flag_t const batch_add = 9_bit;
 
 lt::error_code test_add_torrent(std::string file, add_torrent_test_flag_t const flags)
 {
@@ -93,6 +96,10 @@ lt::error_code test_add_torrent(std::string file, add_torrent_test_flag_t const
 		{
 			ses.async_add_torrent(atp);
 		}
+		else if (flags & batch_add)
+		{
+			ses.async_add_torrents({atp});
+		}
 		else
 		{
 			ses.add_torrent(atp);
@@ -281,3 +288,77 @@ TORRENT_TEST(ec_add_torrent)
 		++i;
 	}
 }
+
+TORRENT_TEST(async_add_torrents)
+{
+	int i = 0;
+	for (auto const& test_case : add_torrent_test_cases)
+	{
+		auto const e = test_add_torrent(test_case.filename, test_case.flags | batch_add);
+		if (e != test_case.expected_error)
+		{
+			std::cerr << "idx: " << i << " " << test_case.filename << '\n';
+			TEST_ERROR(e.message() + " != " + test_case.expected_error.message());
+		}
+		++i;
+	}
+}
+
+TORRENT_TEST(async_add_torrents_deferred_init)
+{
+	lt::session_params p = settings();
+	p.settings.set_int(lt::settings_pack::alert_mask, lt::alert_category::error | lt::alert_category::status);
+	p.settings.set_str(lt::settings_pack::listen_interfaces, "127.0.0.1:6881");
+	// only a single deferred torrent is initialized at a time
+	p.settings.set_int(lt::settings_pack::aio_threads, 1);
+	lt::session ses(p);
+
+	int const num_torrents = 10;
+	std::vector<lt::add_torrent_params> batch;
+	for (int i = 0; i < num_torrents; ++i)
+	{
+		std::vector<lt::create_file_entry> fs;
+		fs.emplace_back("batch_add_" + std::to_string(i), 4 * 0x4000);
+		lt::add_torrent_params atp = make_torrent(std::move(fs), 0x4000);
+		atp.save_path = ".";
+		// every other torrent is queued, and has its initialization deferred
+		if (i % 2 == 0)
+			atp.flags |= lt::torrent_flags::paused | lt::torrent_flags::auto_managed;
+		else
+			atp.flags &= ~(lt::torrent_flags::paused | lt::torrent_flags::auto_managed);
+		batch.push_back(std::move(atp));
+	}
+	ses.async_add_torrents(std::move(batch));
+
+	std::vector<lt::torrent_handle> handles;
+	int checked = 0;
+	std::vector<lt::alert*> alerts;
+	auto const start_time = lt::clock_type::now();
+	while (checked < num_torrents && lt::clock_type::now() - start_time < lt::seconds(10))
+	{
+		ses.wait_for_alert(lt::seconds(1));
+		ses.pop_alerts(&alerts);
+		for (auto const* a : alerts)
+		{
+			std::cout << a->message() << '\n';
+			if (auto const* ta = lt::alert_cast<lt::add_torrent_alert>(a))
+			{
+				TEST_CHECK(!ta->error);
+				handles.push_back(ta->handle);
+			}
+			if (lt::alert_cast<lt::torrent_checked_alert>(a))
+				++checked;
+		}
+	}
+
+	// all torrents are added in order, and eventually initialized
+	TEST_EQUAL(checked, num_torrents);
+	TEST_EQUAL(int(handles.size()), num_torrents);
+	for (int i = 0; i < int(handles.size()); ++i)
+	{
+		lt::torrent_status const st = handles[std::size_t(i)].status();
+		TEST_CHECK(st.state != lt::torrent_status::checking_resume_data);
+		TEST_EQUAL(st.queue_position, lt::queue_position_t{i});
+		TEST_EQUAL(st.name, "batch_add_" + std::to_string(i));
+	}
+}
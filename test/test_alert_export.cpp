@@ -0,0 +1,109 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "test.hpp"
+#include "test_utils.hpp"
+#include "libtorrent/alert_export.hpp"
+#include "libtorrent/alert_types.hpp"
+#include "libtorrent/aux_/alert_manager.hpp"
+#include "libtorrent/aux_/io_bytes.hpp"
+#include "libtorrent/torrent_handle.hpp"
+
+#include <vector>
+
+using namespace lt;
+
+namespace {
+
+std::string to_string(span<char const> s)
+{
+	return std::string(s.data(), std::size_t(s.size()));
+}
+
+} // anonymous namespace
+
+TORRENT_TEST(export_alerts)
+{
+	aux::alert_manager mgr(100, alert_category::all);
+	mgr.emplace_alert<piece_finished_alert>(torrent_handle(), 1337_piece);
+	mgr.emplace_alert<block_finished_alert>(torrent_handle()
+		, tcp::endpoint(make_address_v4("10.0.0.1"), 6881)
+		, peer_id("abcdefghijklmnopqrst"), 3, 42_piece);
+	mgr.emplace_alert<torrent_error_alert>(torrent_handle()
+		, error_code(errors::invalid_file_tag), "foo/bar");
+	mgr.emplace_alert<log_alert>("log message");
+
+	std::vector<alert*> alerts;
+	mgr.get_all(alerts);
+	TEST_EQUAL(alerts.size(), 4);
+
+	std::vector<char> buf(1000);
+	span<char> out = buf;
+	TEST_EQUAL(export_alerts(alerts, out), 4);
+	span<char const> in(buf.data(), buf.size() - std::size_t(out.size()));
+
+	exported_alert e;
+	TEST_CHECK(read_exported_alert(in, e));
+	TEST_EQUAL(e.type, piece_finished_alert::alert_type);
+	TEST_CHECK(e.category == piece_finished_alert::static_category);
+	TEST_EQUAL(e.timestamp, std::chrono::duration_cast<std::chrono::nanoseconds>(
+		alerts[0]->timestamp().time_since_epoch()).count());
+	TEST_EQUAL(e.int_field(alert_field::piece_index), 1337);
+	TEST_EQUAL(e.int_field(alert_field::block_index), -1);
+
+	TEST_CHECK(read_exported_alert(in, e));
+	TEST_EQUAL(e.type, block_finished_alert::alert_type);
+	TEST_EQUAL(e.int_field(alert_field::piece_index), 42);
+	TEST_EQUAL(e.int_field(alert_field::block_index), 3);
+	TEST_EQUAL(to_string(e.field(alert_field::peer_id)), "abcdefghijklmnopqrst");
+	TEST_EQUAL(to_string(e.field(alert_field::endpoint)), std::string("\x0a\x00\x00\x01\x1a\xe1", 6));
+
+	TEST_CHECK(read_exported_alert(in, e));
+	TEST_EQUAL(e.type, torrent_error_alert::alert_type);
+	TEST_EQUAL(to_string(e.field(alert_field::filename)), "foo/bar");
+	span<char const> const err = e.field(alert_field::error);
+	TEST_CHECK(err.size() > 4);
+	char const* ptr = err.data();
+	TEST_EQUAL(aux::read_int32(ptr), int(errors::invalid_file_tag));
+	TEST_EQUAL(to_string(err.subspan(4)), "libtorrent");
+
+	TEST_CHECK(read_exported_alert(in, e));
+	TEST_EQUAL(e.type, log_alert::alert_type);
+	TEST_EQUAL(to_string(e.field(alert_field::message)), "log message");
+	TEST_CHECK(e.field(alert_field::info_hash_v1).empty());
+
+	TEST_CHECK(in.empty());
+	TEST_CHECK(!read_exported_alert(in, e));
+}
+
+TORRENT_TEST(export_alerts_buffer_full)
+{
+	aux::alert_manager mgr(100, alert_category::all);
+	for (int i = 0; i < 10; ++i)
+		mgr.emplace_alert<piece_finished_alert>(torrent_handle(), piece_index_t(i));
+
+	std::vector<alert*> alerts;
+	mgr.get_all(alerts);
+
+	// a piece_finished_alert is the header plus a 4 byte field
+	int const record_size = alert_export_header_size + 3 + 4;
+	std::vector<char> buf(std::size_t(record_size * 3 + record_size / 2));
+	span<char> out = buf;
+	TEST_EQUAL(export_alerts(alerts, out), 3);
+	TEST_EQUAL(out.size(), record_size / 2);
+
+	// partial records are not parsed
+	span<char const> in(buf.data(), record_size * 2 + 10);
+	exported_alert e;
+	TEST_CHECK(read_exported_alert(in, e));
+	TEST_CHECK(read_exported_alert(in, e));
+	TEST_EQUAL(e.int_field(alert_field::piece_index), 1);
+	TEST_CHECK(!read_exported_alert(in, e));
+	TEST_EQUAL(in.size(), 10);
+}
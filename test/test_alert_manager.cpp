@@ -18,6 +18,7 @@ see LICENSE file.
 #include "libtorrent/extensions.hpp"
 #include "setup_transfer.hpp"
 
+#include <algorithm>
 #include <functional>
 #include <thread>
 
@@ -311,6 +312,47 @@ TORRENT_TEST(alerts_dropped_alert)
 	TEST_CHECK(a->dropped_alerts[torrent_finished_alert::alert_type] == true);
 }
 
+// alerts posted from multiple threads while another thread is popping them
+// are all delivered, exactly once
+TORRENT_TEST(concurrent_get_all)
+{
+	int const num_threads = 4;
+	int const num_alerts = 10000;
+	aux::alert_manager mgr(num_threads * num_alerts, alert_category::all);
+
+	std::vector<std::thread> producers;
+	for (int i = 0; i < num_threads; ++i)
+	{
+		producers.emplace_back([&mgr] {
+			for (int k = 0; k < num_alerts; ++k)
+				mgr.emplace_alert<piece_finished_alert>(torrent_handle(), piece_index_t(k));
+		});
+	}
+
+	std::vector<int> received(num_alerts, 0);
+	int total = 0;
+	std::vector<alert*> alerts;
+	for (int i = 0; i < 1000 && total < num_threads * num_alerts; ++i)
+	{
+		mgr.wait_for_alert(lt::milliseconds(10));
+		mgr.get_all(alerts);
+		for (alert const* a : alerts)
+		{
+			auto const* pf = alert_cast<piece_finished_alert>(a);
+			TEST_CHECK(pf);
+			if (!pf) continue;
+			++received[std::size_t(static_cast<int>(pf->piece_index))];
+			++total;
+		}
+	}
+
+	for (auto& t : producers) t.join();
+	TEST_EQUAL(total, num_threads * num_alerts);
+	TEST_CHECK(std::all_of(received.begin(), received.end()
+		, [](int const n) { return n == num_threads; }));
+	TEST_CHECK(!mgr.pending());
+}
+
 #ifndef TORRENT_DISABLE_EXTENSIONS
 struct post_plugin : lt::plugin
 {
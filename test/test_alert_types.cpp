@@ -169,10 +169,11 @@ TORRENT_TEST(alerts_types)
 	TEST_ALERT_TYPE(file_priorities_alert, 105, alert_priority::critical, alert_category::status);
 	TEST_ALERT_TYPE(file_status_alert, 106, alert_priority::critical, alert_category::status);
 	TEST_ALERT_TYPE(ip_ban_alert, 107, alert_priority::normal, alert_category::ip_block);
+	TEST_ALERT_TYPE(status_delta_alert, 108, alert_priority::high, alert_category::status);
 
 #undef TEST_ALERT_TYPE
 
-	TEST_EQUAL(num_alert_types, 108);
+	TEST_EQUAL(num_alert_types, 109);
 	TEST_EQUAL(num_alert_types, count_alert_types);
 }
 
@@ -14,6 +14,7 @@ see LICENSE file.
 #include "libtorrent/bitfield.hpp"
 #include "libtorrent/aux_/cpuid.hpp"
 #include <cstdlib>
+#include <vector>
 
 using namespace lt;
 
@@ -431,3 +432,35 @@ TORRENT_TEST(bitfield_index_range)
 	TEST_EQUAL(sum, 15 * 16 / 2);
 }
 
+
+TORRENT_TEST(for_each_set_bit)
+{
+	bitfield test1(130, false);
+	std::vector<int> const expected = {0, 1, 31, 32, 63, 64, 100, 129};
+	for (int i : expected) test1.set_bit(i);
+
+	std::vector<int> visited;
+	TEST_CHECK(!test1.for_each_set_bit([&](int const i) { visited.push_back(i); return false; }));
+	TEST_CHECK(visited == expected);
+
+	// stop early
+	visited.clear();
+	TEST_CHECK(test1.for_each_set_bit([&](int const i) { visited.push_back(i); return i == 63; }));
+	TEST_CHECK((visited == std::vector<int>{0, 1, 31, 32, 63}));
+
+	// odd sizes and all bits set
+	for (int size : {0, 1, 31, 32, 33, 95})
+	{
+		bitfield test2(size, true);
+		int count = 0;
+		int last = -1;
+		test2.for_each_set_bit([&](int const i) { TEST_CHECK(i > last); last = i; ++count; return false; });
+		TEST_EQUAL(count, size);
+	}
+
+	typed_bitfield<int> test3(10, false);
+	test3.set_bit(7);
+	int found = -1;
+	test3.for_each_set_bit([&](int const i) { found = i; return false; });
+	TEST_EQUAL(found, 7);
+}
@@ -0,0 +1,86 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "test.hpp"
+#include "libtorrent/aux_/choker.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace lt;
+
+namespace {
+
+aux::unchoke_candidate candidate(int const prio, std::int64_t const downloaded
+	, bool const quota_complete, std::int64_t const score, int const unchoked)
+{
+	aux::unchoke_candidate c;
+	c.priority = prio;
+	c.downloaded = downloaded;
+	c.quota_complete = quota_complete;
+	c.score = score;
+	c.last_unchoke = time_point(seconds(unchoked));
+	return c;
+}
+
+} // anonymous namespace
+
+TORRENT_TEST(unchoke_candidate_order)
+{
+	// priority first
+	TEST_CHECK(candidate(2, 0, false, 0, 0) < candidate(1, 100, false, 100, 0));
+	// then what they have sent us
+	TEST_CHECK(candidate(1, 100, true, 0, 10) < candidate(1, 50, false, 100, 0));
+	// peers that have received their quota yield their slot
+	TEST_CHECK(candidate(1, 0, false, 0, 10) < candidate(1, 0, true, 100, 0));
+	// then peers requesting pieces that are in memory
+	auto cached = candidate(1, 0, false, 0, 10);
+	cached.cached_requests = true;
+	TEST_CHECK(cached < candidate(1, 0, false, 100, 0));
+	cached.quota_complete = true;
+	TEST_CHECK(candidate(1, 0, false, 0, 10) < cached);
+	// then the seed choker's score
+	TEST_CHECK(candidate(1, 0, false, 100, 10) < candidate(1, 0, false, 50, 0));
+	// and the peer that has waited the longest
+	TEST_CHECK(candidate(1, 0, false, 0, 0) < candidate(1, 0, false, 0, 10));
+	TEST_CHECK(!(candidate(1, 0, false, 0, 10) < candidate(1, 0, false, 0, 10)));
+}
+
+TORRENT_TEST(select_unchoke_candidates)
+{
+	std::vector<aux::unchoke_candidate> c;
+	for (int i = 0; i < 100; ++i)
+		c.push_back(candidate(1, (i * 37) % 100, false, 0, 0));
+
+	aux::select_unchoke_candidates(c, 10);
+	std::vector<std::int64_t> top;
+	for (int i = 0; i < 10; ++i) top.push_back(c[std::size_t(i)].downloaded);
+	std::sort(top.begin(), top.end());
+	for (int i = 0; i < 10; ++i) TEST_EQUAL(top[std::size_t(i)], 90 + i);
+
+	// more slots than candidates leaves them all in place
+	aux::select_unchoke_candidates(c, 1000);
+	TEST_EQUAL(int(c.size()), 100);
+}
+
+TORRENT_TEST(rate_based_unchoke_slots)
+{
+	// the threshold starts at 1024 and increases by 2048 for every peer
+	std::vector<std::pair<std::int64_t, int>> rates = {
+		{1000, 1000}, {10000, 10000}, {4000, 4000}, {50000, 50000}, {0, 0}};
+	// 50000 >= 1024, 10000 >= 3072, 4000 >= 5120 fails. Plus one slot
+	TEST_EQUAL(aux::rate_based_unchoke_slots(rates, 1024), 3);
+
+	std::vector<std::pair<std::int64_t, int>> none;
+	TEST_EQUAL(aux::rate_based_unchoke_slots(none, 1024), 1);
+
+	// all peers above the threshold
+	std::vector<std::pair<std::int64_t, int>> fast = {{100000, 100000}, {100000, 100000}};
+	TEST_EQUAL(aux::rate_based_unchoke_slots(fast, 1024), 3);
+}
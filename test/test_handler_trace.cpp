@@ -0,0 +1,91 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "test.hpp"
+#include "libtorrent/handler_trace.hpp"
+#include "libtorrent/aux_/handler_trace.hpp"
+
+#include <string>
+#include <thread>
+
+using namespace lt;
+
+namespace {
+
+int count(std::string const& str, std::string const& needle)
+{
+	int ret = 0;
+	for (auto pos = str.find(needle); pos != std::string::npos
+		; pos = str.find(needle, pos + needle.size()))
+		++ret;
+	return ret;
+}
+
+} // anonymous namespace
+
+TORRENT_TEST(trace_events)
+{
+	clear_handler_trace();
+
+	time_point const start = clock_type::now();
+	aux::record_trace_event("explicit", start, start + microseconds(1500));
+	{
+		aux::trace_scope s("scope \"quoted\"");
+	}
+
+	std::string const trace = handler_trace_json();
+	TEST_CHECK(trace.find("{\"traceEvents\":[") == 0);
+	TEST_EQUAL(count(trace, "\"ph\":\"X\""), 2);
+	TEST_EQUAL(count(trace, "\"name\":\"explicit\""), 1);
+	TEST_EQUAL(count(trace, "\"dur\":1500.000,"), 1);
+	TEST_EQUAL(count(trace, "\"name\":\"scope \\\"quoted\\\"\""), 1);
+}
+
+TORRENT_TEST(trace_threads)
+{
+	clear_handler_trace();
+
+	{
+		aux::trace_scope s("main_thread");
+	}
+	std::thread t([] { aux::trace_scope s("other_thread"); });
+	t.join();
+
+	std::string const trace = handler_trace_json();
+	auto const main_pos = trace.find("\"name\":\"main_thread\"");
+	auto const other_pos = trace.find("\"name\":\"other_thread\"");
+	TEST_CHECK(main_pos != std::string::npos);
+	TEST_CHECK(other_pos != std::string::npos);
+
+	// the events are recorded in different ring buffers, with different
+	// thread IDs
+	auto const tid = [&](std::string::size_type const pos)
+	{
+		auto const tid_pos = trace.find("\"tid\":", pos);
+		return trace.substr(tid_pos, trace.find('}', tid_pos) - tid_pos);
+	};
+	TEST_CHECK(tid(main_pos) != tid(other_pos));
+}
+
+TORRENT_TEST(trace_ring_wraps)
+{
+	clear_handler_trace();
+
+	time_point const start = clock_type::now();
+	aux::record_trace_event("oldest", start, start);
+	for (int i = 0; i < aux::trace_ring_size; ++i)
+		aux::record_trace_event("event", start, start);
+
+	std::string const trace = handler_trace_json();
+	TEST_EQUAL(count(trace, "\"name\":\"oldest\""), 0);
+	TEST_EQUAL(count(trace, "\"name\":\"event\""), aux::trace_ring_size);
+
+	clear_handler_trace();
+	TEST_EQUAL(count(handler_trace_json(), "\"ph\":\"X\""), 0);
+}
@@ -12,6 +12,7 @@ see LICENSE file.
 
 #include "libtorrent/aux_/mmap.hpp"
 #include <fstream>
+#include <algorithm>
 
 #include "libtorrent/aux_/disable_warnings_push.hpp"
 #include <boost/range/combine.hpp>
@@ -60,6 +61,40 @@ TORRENT_TEST(mmap_read)
 	}
 }
 
+TORRENT_TEST(mmap_resident_pages)
+{
+	std::vector<char> buf = filled_buffer(1024 * 1024);
+
+	{
+		std::ofstream file("test_file3", std::ios::binary);
+		file.write(buf.data(), std::streamsize(buf.size()));
+	}
+
+	auto m = std::make_shared<file_mapping>(aux::file_handle("test_file3"
+		, std::int64_t(buf.size()), open_mode::read_only)
+		, open_mode::read_only, buf.size()
+#if TORRENT_HAVE_MAP_VIEW_OF_FILE
+		, std::make_shared<std::mutex>()
+#endif
+		);
+
+	// reading every page brings it into memory
+	TEST_CHECK(std::equal(buf.begin(), buf.end(), m->range().begin()));
+
+	std::vector<std::uint8_t> pages;
+	int const page_size = m->resident_pages(pages);
+#if TORRENT_HAVE_MMAP
+	TEST_CHECK(page_size > 0);
+	if (page_size > 0)
+		TEST_EQUAL(int(pages.size()), (int(buf.size()) + page_size - 1) / page_size);
+	TEST_CHECK(std::all_of(pages.begin(), pages.end()
+		, [](std::uint8_t const p) { return p != 0; }));
+#else
+	TEST_EQUAL(page_size, 0);
+	TEST_CHECK(pages.empty());
+#endif
+}
+
 TORRENT_TEST(mmap_write)
 {
 	std::vector<char> buf = filled_buffer(1024 * 1024);
@@ -12,13 +12,16 @@ see LICENSE file.
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <thread>
 
 #include "libtorrent/hasher.hpp"
 #include "libtorrent/hex.hpp"
 #include "libtorrent/aux_/pe_crypto.hpp"
+#include "libtorrent/aux_/dh_key_pool.hpp"
 #include "libtorrent/aux_/random.hpp"
 #include "libtorrent/span.hpp"
 
@@ -121,6 +124,39 @@ TORRENT_TEST(diffie_hellman)
 	}
 }
 
+TORRENT_TEST(dh_key_pool)
+{
+	using namespace lt;
+
+	aux::dh_key_pool pool;
+
+	// a disabled pool still hands out keys, generated inline
+	TEST_EQUAL(pool.num_ready(), 0);
+	auto const inline_key = pool.take();
+	TEST_CHECK(inline_key);
+
+	pool.set_size(4);
+	for (int i = 0; i < 1000 && pool.num_ready() < 4; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	TEST_EQUAL(pool.num_ready(), 4);
+
+	// keys from the pool are unique and usable for a key exchange
+	auto k1 = pool.take();
+	auto k2 = pool.take();
+	TEST_CHECK(k1->get_local_key() != k2->get_local_key());
+	TEST_CHECK(k1->compute_secret(reinterpret_cast<std::uint8_t const*>(k2->get_local_key().data())));
+	TEST_CHECK(k2->compute_secret(reinterpret_cast<std::uint8_t const*>(k1->get_local_key().data())));
+	TEST_CHECK(k1->get_secret() == k2->get_secret());
+
+	// shrinking the pool discards the excess keys
+	pool.set_size(1);
+	TEST_CHECK(pool.num_ready() <= 1);
+
+	pool.abort();
+	TEST_EQUAL(pool.num_ready(), 0);
+	TEST_CHECK(pool.take());
+}
+
 TORRENT_TEST(diffie_hellman_degenerate_key)
 {
 	using namespace lt;
@@ -23,7 +23,9 @@ see LICENSE file.
 #include "setup_transfer.hpp"
 #include <vector>
 #include <memory> // for shared_ptr
+#include <algorithm>
 #include <cstdarg>
+#include <cstdio>
 
 using namespace lt;
 using namespace lt::aux;
@@ -1255,17 +1257,86 @@ TORRENT_TEST(clear_peers)
 	p.connect_one_peer(1, &st);
 
 	TEST_EQUAL(p.num_peers(), 3);
-	TEST_EQUAL(p.num_candidate_cache(), 2);
+	TEST_EQUAL(p.connect_queue_size(), 3);
 	TEST_EQUAL(p.num_connect_candidates(), 3);
 	TEST_EQUAL(p.num_seeds(), 1);
 
 	p.clear();
 	TEST_EQUAL(p.num_peers(), 0);
-	TEST_EQUAL(p.num_candidate_cache(), 0);
+	TEST_EQUAL(p.connect_queue_size(), 0);
 	TEST_EQUAL(p.num_connect_candidates(), 0);
 	TEST_EQUAL(p.num_seeds(), 0);
 }
 
+// most peers in the list have failed too many times to be connect
+// candidates. Make sure the ones that are left are the only ones picked, and
+// that a peer that's given another chance is picked up again
+TORRENT_TEST(connect_candidates_sparse)
+{
+	torrent_state st = init_state();
+	peer_list p(allocator);
+
+	std::vector<torrent_peer*> candidates;
+	std::vector<torrent_peer*> failed;
+	for (int i = 0; i < 500; ++i)
+	{
+		char addr[20];
+		std::snprintf(addr, sizeof(addr), "10.0.%d.%d", i / 200, i % 200 + 1);
+		torrent_peer* peer = add_peer(p, st, ep(addr, 8080));
+		TEST_CHECK(peer);
+		if (peer == nullptr) continue;
+		if (i % 100 == 7) candidates.push_back(peer);
+		else
+		{
+			p.set_failcount(peer, st.max_failcount);
+			failed.push_back(peer);
+		}
+	}
+	TEST_EQUAL(p.num_connect_candidates(), int(candidates.size()));
+
+	for (int i = 0; i < int(candidates.size()); ++i)
+	{
+		torrent_peer* tp = p.connect_one_peer(0, &st);
+		TEST_CHECK(std::find(candidates.begin(), candidates.end(), tp) != candidates.end());
+		if (tp == nullptr) break;
+		p.set_failcount(tp, st.max_failcount);
+	}
+	TEST_EQUAL(p.num_connect_candidates(), 0);
+	TEST_CHECK(p.connect_one_peer(0, &st) == nullptr);
+
+	p.set_failcount(failed[123], 0);
+	TEST_EQUAL(p.num_connect_candidates(), 1);
+	TEST_CHECK(p.connect_one_peer(0, &st) == failed[123]);
+}
+
+// peers we have connected to recently aren't picked until their retry time
+// has passed, even if they're better candidates
+TORRENT_TEST(connect_candidates_retry_time)
+{
+	torrent_state st = init_state();
+	st.min_reconnect_time = 60;
+	peer_list p(allocator);
+
+	torrent_peer* peer1 = add_peer(p, st, ep("10.0.0.1", 8080));
+	torrent_peer* peer2 = add_peer(p, st, ep("10.0.0.2", 8080));
+	TEST_CHECK(peer1);
+	TEST_CHECK(peer2);
+
+	// peer2 has failed once, so peer1 is the better candidate. But we
+	// connected to it at time 100
+	p.inc_failcount(peer2);
+	peer1->last_connected = 100;
+
+	TEST_CHECK(p.connect_one_peer(120, &st) == peer2);
+	p.set_failcount(peer2, st.max_failcount);
+	TEST_EQUAL(p.num_connect_candidates(), 1);
+
+	TEST_CHECK(p.connect_one_peer(120, &st) == nullptr);
+	TEST_CHECK(p.connect_one_peer(159, &st) == nullptr);
+	TEST_CHECK(p.connect_one_peer(160, &st) == peer1);
+	TEST_EQUAL(p.connect_queue_size(), 1);
+}
+
 // TODO: test erasing peers
 // TODO: test update_peer_port with allow_multiple_connections_per_ip and without
 // TODO: test add i2p peers
@@ -24,6 +24,7 @@ see LICENSE file.
 #include <vector>
 #include <set>
 #include <map>
+#include <string>
 #include <iostream>
 
 #include "test.hpp"
@@ -486,6 +487,36 @@ TORRENT_TEST(pick_lowest_availability)
 	TEST_CHECK(test_pick(p) == 1_piece);
 }
 
+TORRENT_TEST(pick_lowest_availability_sparse_peer)
+{
+	// with enough pieces, a peer that only has a few of them is picked from
+	// by walking its bitfield rather than the whole piece list. That must
+	// still pick the rarest pieces first
+	std::string availability(64, '5');
+	availability[3] = '6';
+	availability[10] = '3';
+	availability[40] = '2';
+	availability[63] = '4';
+	std::string const have(64, ' ');
+	auto p = setup_picker(availability.c_str(), have.c_str(), "", "");
+
+	std::string peer_pieces(64, ' ');
+	peer_pieces[3] = '*';
+	peer_pieces[10] = '*';
+	peer_pieces[40] = '*';
+	peer_pieces[63] = '*';
+	auto const picked = pick_pieces(p, peer_pieces.c_str(), 4 * blocks_per_piece
+		, 0, nullptr);
+
+	TEST_EQUAL(int(picked.size()), 4 * blocks_per_piece);
+	piece_index_t const expected[] = {40_piece, 10_piece, 63_piece, 3_piece};
+	for (int i = 0; i < int(picked.size()); ++i)
+	{
+		TEST_CHECK(picked[std::size_t(i)] == piece_block(expected[i / blocks_per_piece]
+			, i % blocks_per_piece));
+	}
+}
+
 TORRENT_TEST(random_pick_at_same_priority)
 {
 	// make sure pieces with equal priority and availability
@@ -576,6 +607,20 @@ TORRENT_TEST(distributed_copies)
 	TEST_CHECK(dc == std::make_pair(2, 5000 / 7));
 }
 
+TORRENT_TEST(distributed_copies_from_availability)
+{
+	// the free function is used for seeds, without a piece picker. It should
+	// agree with the piece picker, given the same availability (the picker
+	// counts ourself for the pieces we have)
+	std::vector<int> const avail = {2, 2, 3, 3, 3, 3, 3};
+	TEST_CHECK(aux::distributed_copies(avail) == std::make_pair(2, 5000 / 7));
+
+	std::vector<int> const uniform = {4, 4, 4};
+	TEST_CHECK(aux::distributed_copies(uniform) == std::make_pair(4, 0));
+
+	TEST_CHECK(aux::distributed_copies({}) == std::make_pair(1, 0));
+}
+
 TORRENT_TEST(filtered_pieces)
 {
 	// make sure filtered pieces are ignored
@@ -1995,6 +2040,30 @@ TORRENT_TEST(break_one_seed)
 	TEST_EQUAL(p->piece_stats(3_piece).peer_count, 3);
 }
 
+TORRENT_TEST(uncounted_peers)
+{
+	// pieces no counted peer has aren't pickable
+	auto p = setup_picker("2100000", "       ", "", "");
+	auto picked = pick_pieces(p, "   *   ", 1, 0, nullptr);
+	TEST_CHECK(picked.empty());
+
+	// until a peer outside the availability sample joins, since it may have
+	// any piece
+	p->inc_uncounted_peer();
+	picked = pick_pieces(p, "   *   ", 1, 0, nullptr);
+	TEST_CHECK(picked.size() == 1 && picked[0].piece_index == 3_piece);
+
+	// uncounted peers don't affect availability or the rarest-first order
+	TEST_EQUAL(p->get_availability(0_piece), 2);
+	TEST_EQUAL(p->get_availability(3_piece), 0);
+	picked = pick_pieces(p, "**     ", 1, 0, nullptr);
+	TEST_CHECK(picked.size() == 1 && picked[0].piece_index == 1_piece);
+
+	p->dec_uncounted_peer();
+	picked = pick_pieces(p, "   *   ", 1, 0, nullptr);
+	TEST_CHECK(picked.empty());
+}
+
 TORRENT_TEST(we_dont_have2)
 {
 	auto p = setup_picker("1111111", "* *    ", "1101111", "");
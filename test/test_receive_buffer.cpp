@@ -12,6 +12,9 @@ see LICENSE file.
 #include "test.hpp"
 #include "libtorrent/aux_/receive_buffer.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace lt;
 using lt::aux::receive_buffer;
 
@@ -201,6 +204,34 @@ TORRENT_TEST(receive_buffer_watermark)
 	TEST_EQUAL(b.watermark(), 33500000);
 }
 
+TORRENT_TEST(receive_buffer_recycle)
+{
+	char const* first = nullptr;
+	{
+		receive_buffer b;
+		b.reset(12345);
+		first = b.reserve(12345).data();
+	}
+
+	// the buffer released by the first receive buffer is reused by the next
+	// one, asking for a similar size
+	receive_buffer b;
+	b.reset(12000);
+	span<char> const r = b.reserve(12000);
+	TEST_CHECK(r.data() == first);
+	TEST_CHECK(b.capacity() >= 12345);
+
+	// and the data received so far is preserved when the buffer is replaced
+	std::memset(r.data(), 'a', 100);
+	b.received(100);
+	b.advance_pos(100);
+	b.grow(100000);
+	TEST_CHECK(b.capacity() >= 12000);
+	span<char const> const packet = b.get();
+	TEST_EQUAL(packet.size(), 100);
+	TEST_CHECK(std::all_of(packet.begin(), packet.end(), [](char c) { return c == 'a'; }));
+}
+
 #if !defined(TORRENT_DISABLE_ENCRYPTION) && !defined(TORRENT_DISABLE_EXTENSIONS)
 
 TORRENT_TEST(recv_buffer_mutable_buffers)
@@ -1838,3 +1838,138 @@ TORRENT_TEST(removed)
 	alert const* a = wait_for_alert(ses, save_resume_data_failed_alert::alert_type);
 	TEST_CHECK(a != nullptr);
 }
+
+TORRENT_TEST(resume_delta_encoding)
+{
+	add_torrent_params base;
+	base.info_hashes.v1 = sha1_hash("abababababababababab");
+	base.have_pieces.resize(1000, false);
+	base.have_pieces.set_bit(1_piece);
+	base.piece_priorities.assign(1000, default_priority);
+	base.piece_priorities[3] = top_priority;
+
+	add_torrent_params delta;
+	delta.info_hashes = base.info_hashes;
+	delta.resume_delta = true;
+	delta.have_pieces.resize(1000, false);
+	delta.have_pieces.set_bit(5_piece);
+	delta.have_pieces.set_bit(700_piece);
+	delta.total_uploaded = 1337;
+
+	// a few pieces are saved as a list of indices rather than a bitmask
+	entry const e = write_resume_data(delta);
+	TEST_CHECK(e.find_key("new-pieces") != nullptr);
+	TEST_CHECK(e.find_key("pieces") == nullptr);
+	TEST_EQUAL(e["new-pieces"].string().size(), 8);
+
+	std::vector<char> const base_buf = write_resume_data_buf(base);
+	std::vector<std::vector<char>> const deltas{write_resume_data_buf(delta)};
+
+	add_torrent_params const d = read_resume_data(deltas[0]);
+	TEST_CHECK(d.resume_delta);
+	TEST_EQUAL(d.have_pieces.count(), 2);
+	TEST_CHECK(d.have_pieces.get_bit(5_piece));
+	TEST_CHECK(d.have_pieces.get_bit(700_piece));
+
+	error_code ec;
+	add_torrent_params const atp = read_resume_data(base_buf, deltas, ec);
+	TEST_CHECK(!ec);
+	TEST_CHECK(!atp.resume_delta);
+	TEST_EQUAL(atp.have_pieces.size(), 1000);
+	TEST_EQUAL(atp.have_pieces.count(), 3);
+	TEST_CHECK(atp.have_pieces.get_bit(1_piece));
+	TEST_CHECK(atp.have_pieces.get_bit(5_piece));
+	TEST_CHECK(atp.have_pieces.get_bit(700_piece));
+	// the delta didn't change the priorities
+	TEST_EQUAL(atp.piece_priorities.size(), 1000);
+	TEST_EQUAL(atp.piece_priorities[3], top_priority);
+	// but everything else is taken from the delta
+	TEST_EQUAL(atp.total_uploaded, 1337);
+
+	// a delta can't be the base
+	read_resume_data(deltas[0], deltas, ec);
+	TEST_EQUAL(ec, error_code(errors::invalid_file_tag));
+
+	// nor can a delta of a different torrent be folded in
+	delta.info_hashes.v1 = sha1_hash("cdcdcdcdcdcdcdcdcdcd");
+	std::vector<std::vector<char>> const other{write_resume_data_buf(delta)};
+	ec.clear();
+	add_torrent_params const partial = read_resume_data(base_buf, other, ec);
+	TEST_EQUAL(ec, error_code(errors::mismatching_info_hash));
+	TEST_EQUAL(partial.have_pieces.count(), 1);
+}
+
+TORRENT_TEST(save_resume_delta)
+{
+	lt::add_torrent_params p = generate_torrent(true, true);
+	p.save_path = ".";
+	p.have_pieces.resize(p.ti->num_pieces(), false);
+	p.have_pieces.set_bit(0_piece);
+
+	lt::session ses(settings());
+	torrent_handle h = ses.add_torrent(p);
+	wait_for_alert(ses, torrent_checked_alert::alert_type, "save_resume_delta");
+
+	auto save = [&](resume_data_flags_t const flags) -> add_torrent_params
+	{
+		h.save_resume_data(flags);
+		auto const* a = alert_cast<save_resume_data_alert>(
+			wait_for_alert(ses, save_resume_data_alert::alert_type, "save_resume_delta"));
+		TEST_CHECK(a);
+		return a ? a->params : add_torrent_params{};
+	};
+
+	// the first save has nothing to be relative to
+	add_torrent_params const full = save(torrent_handle::save_delta);
+	TEST_CHECK(!full.resume_delta);
+	TEST_EQUAL(full.have_pieces.count(), 1);
+	TEST_EQUAL(full.merkle_trees.size(), 3);
+
+	// piece 8 is the only piece of the second file
+	piece_index_t const piece = 8_piece;
+	file_index_t const file{1};
+	TEST_EQUAL(p.ti->layout().file_index_at_piece(piece), file);
+	std::vector<char> const zeros(std::size_t(p.ti->piece_length()), 0);
+	h.add_piece(piece, zeros.data());
+	for (int i = 0; i < 100; ++i)
+	{
+		if (h.get_resume_data().have_pieces.get_bit(piece)) break;
+		std::this_thread::sleep_for(lt::milliseconds(50));
+	}
+
+	add_torrent_params const delta1 = save(torrent_handle::save_delta);
+	TEST_CHECK(delta1.resume_delta);
+	TEST_EQUAL(delta1.have_pieces.count(), 1);
+	TEST_CHECK(delta1.have_pieces.get_bit(piece));
+	TEST_CHECK(delta1.piece_priorities.empty());
+	// only the tree of the file we completed a piece of is saved
+	TEST_EQUAL(delta1.merkle_trees.size(), 3);
+	for (auto const f : delta1.merkle_trees.range())
+		TEST_EQUAL(delta1.merkle_trees[f].empty(), f != file);
+
+	h.piece_priority(2_piece, top_priority);
+	add_torrent_params const delta2 = save(torrent_handle::save_delta);
+	TEST_CHECK(delta2.resume_delta);
+	TEST_CHECK(delta2.have_pieces.none_set());
+	TEST_CHECK(delta2.merkle_trees.empty());
+	TEST_EQUAL(int(delta2.piece_priorities.size()), p.ti->num_pieces());
+
+	// folding the deltas into the full save gives the same state as saving
+	// it in full
+	std::vector<std::vector<char>> const deltas{
+		write_resume_data_buf(delta1), write_resume_data_buf(delta2)};
+	error_code ec;
+	add_torrent_params const folded = read_resume_data(
+		write_resume_data_buf(full), deltas, ec);
+	TEST_CHECK(!ec);
+
+	// bitfields are padded to whole bytes when read back, so compare them
+	// encoded
+	add_torrent_params const current = h.get_resume_data();
+	TEST_CHECK(!current.resume_delta);
+	entry const e1 = write_resume_data(folded);
+	entry const e2 = write_resume_data(current);
+	TEST_CHECK(e1["pieces"] == e2["pieces"]);
+	TEST_CHECK(e1["piece_priority"] == e2["piece_priority"]);
+	TEST_CHECK(e1["trees"] == e2["trees"]);
+}
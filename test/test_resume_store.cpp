@@ -0,0 +1,210 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "test.hpp"
+#include "test_utils.hpp"
+#include "libtorrent/resume_store.hpp"
+#include "libtorrent/add_torrent_params.hpp"
+#include "libtorrent/aux_/path.hpp"
+
+#include <fstream>
+
+using namespace lt;
+
+namespace {
+
+char const* const store_path = "test_resume_store.dat";
+
+add_torrent_params make_params(char const c, int const num_pieces = 100)
+{
+	add_torrent_params atp;
+	atp.info_hashes.v1 = sha1_hash(std::string(20, c));
+	atp.save_path = std::string("save-path-") + c;
+	atp.have_pieces.resize(num_pieces, false);
+	return atp;
+}
+
+std::int64_t file_size(char const* path)
+{
+	error_code ec;
+	file_status st;
+	stat_file(path, &st, ec);
+	return ec ? 0 : st.file_size;
+}
+
+void remove_store()
+{
+	error_code ec;
+	lt::remove(store_path, ec);
+}
+
+} // anonymous namespace
+
+TORRENT_TEST(resume_store_empty)
+{
+	remove_store();
+	resume_store s(store_path);
+	error_code ec;
+	TEST_CHECK(s.load(ec).empty());
+	TEST_CHECK(!ec);
+	TEST_CHECK(!s.flush());
+	// nothing was written, so there's no file
+	TEST_EQUAL(file_size(store_path), 0);
+}
+
+TORRENT_TEST(resume_store_save_load)
+{
+	remove_store();
+	{
+		resume_store s(store_path);
+		error_code ec;
+		TEST_CHECK(s.load(ec).empty());
+
+		add_torrent_params a = make_params('a');
+		a.have_pieces.set_bit(1_piece);
+		s.save(a);
+		s.save(make_params('b'));
+		s.save(make_params('c'));
+
+		// a delta, adding piece 2 to 'a'
+		add_torrent_params delta = make_params('a');
+		delta.have_pieces.set_bit(2_piece);
+		delta.resume_delta = true;
+		s.save(delta);
+
+		s.remove(make_params('b').info_hashes);
+
+		// a full save of 'c' replaces the previous one
+		add_torrent_params c = make_params('c');
+		c.save_path = "new-save-path";
+		s.save(c);
+		TEST_CHECK(!s.flush());
+	}
+
+	resume_store s(store_path);
+	error_code ec;
+	std::vector<add_torrent_params> const atps = s.load(ec);
+	TEST_CHECK(!ec);
+	TEST_EQUAL(atps.size(), 2);
+	if (atps.size() != 2) return;
+
+	// in the order they were first saved
+	TEST_EQUAL(atps[0].info_hashes, make_params('a').info_hashes);
+	TEST_CHECK(!atps[0].resume_delta);
+	TEST_EQUAL(atps[0].have_pieces.count(), 2);
+	TEST_CHECK(atps[0].have_pieces.get_bit(1_piece));
+	TEST_CHECK(atps[0].have_pieces.get_bit(2_piece));
+	TEST_EQUAL(atps[0].save_path, "save-path-a");
+
+	TEST_EQUAL(atps[1].info_hashes, make_params('c').info_hashes);
+	TEST_EQUAL(atps[1].save_path, "new-save-path");
+}
+
+TORRENT_TEST(resume_store_compact)
+{
+	remove_store();
+	{
+		resume_store s(store_path);
+		for (int i = 0; i < 50; ++i)
+		{
+			add_torrent_params a = make_params('a', 10000);
+			a.have_pieces.set_bit(piece_index_t(i));
+			s.save(a);
+		}
+		for (int i = 0; i < 20; ++i)
+		{
+			add_torrent_params delta = make_params('b', 10000);
+			delta.have_pieces.set_bit(piece_index_t(i));
+			delta.resume_delta = i > 0;
+			s.save(delta);
+		}
+		TEST_CHECK(!s.flush());
+		std::int64_t const before = file_size(store_path);
+
+		s.compact();
+		TEST_CHECK(!s.flush());
+		std::int64_t const after = file_size(store_path);
+		TEST_CHECK(after * 10 < before);
+
+		// the store can still be appended to after compacting
+		add_torrent_params c = make_params('c');
+		s.save(c);
+		TEST_CHECK(!s.flush());
+	}
+
+	resume_store s(store_path);
+	error_code ec;
+	std::vector<add_torrent_params> const atps = s.load(ec);
+	TEST_CHECK(!ec);
+	TEST_EQUAL(atps.size(), 3);
+	if (atps.size() != 3) return;
+
+	TEST_EQUAL(atps[0].have_pieces.count(), 1);
+	TEST_CHECK(atps[0].have_pieces.get_bit(49_piece));
+	TEST_EQUAL(atps[1].have_pieces.count(), 20);
+	TEST_CHECK(!atps[1].resume_delta);
+	TEST_EQUAL(atps[2].info_hashes, make_params('c').info_hashes);
+}
+
+TORRENT_TEST(resume_store_torn_tail)
+{
+	remove_store();
+	{
+		resume_store s(store_path);
+		s.save(make_params('a'));
+		s.save(make_params('b'));
+		TEST_CHECK(!s.flush());
+	}
+
+	// simulate a crash in the middle of writing a record
+	std::int64_t const size = file_size(store_path);
+	{
+		std::ofstream f(store_path, std::ios::binary | std::ios::app);
+		f.write("\x00\x00\x01\x00garbage", 11);
+	}
+	TEST_EQUAL(file_size(store_path), size + 11);
+
+	{
+		resume_store s(store_path);
+		error_code ec;
+		TEST_EQUAL(s.load(ec).size(), 2);
+		TEST_CHECK(!ec);
+
+		// the partial record must not hide the ones written after it
+		s.save(make_params('c'));
+		TEST_CHECK(!s.flush());
+	}
+
+	resume_store s(store_path);
+	error_code ec;
+	std::vector<add_torrent_params> const atps = s.load(ec);
+	TEST_CHECK(!ec);
+	TEST_EQUAL(atps.size(), 3);
+	if (atps.size() != 3) return;
+	TEST_EQUAL(atps[2].info_hashes, make_params('c').info_hashes);
+}
+
+TORRENT_TEST(resume_store_invalid_file)
+{
+	remove_store();
+	{
+		std::ofstream f(store_path, std::ios::binary);
+		f.write("not a resume store", 18);
+	}
+
+	resume_store s(store_path);
+	error_code ec;
+	TEST_CHECK(s.load(ec).empty());
+	TEST_EQUAL(ec, error_code(errors::invalid_file_tag));
+
+	// a file we don't understand is never overwritten
+	s.save(make_params('a'));
+	TEST_EQUAL(s.flush(), error_code(errors::invalid_file_tag));
+	TEST_EQUAL(file_size(store_path), 18);
+}
@@ -26,6 +26,8 @@ see LICENSE file.
 
 #include <functional>
 #include <fstream>
+#include <memory>
+#include <vector>
 
 using namespace std::placeholders;
 using namespace lt;
@@ -208,6 +210,49 @@ TORRENT_TEST(async_add_torrent_duplicate_back_to_back)
 }
 
 #if TORRENT_ABI_VERSION < 4
+TORRENT_TEST(post_status_deltas)
+{
+	lt::session ses(settings());
+
+	add_torrent_params atp;
+	atp.info_hashes.v1.assign("abababababababababab");
+	atp.save_path = ".";
+	atp.flags |= torrent_flags::paused;
+	atp.flags &= ~torrent_flags::auto_managed;
+	torrent_handle h = ses.add_torrent(atp);
+
+	status_field_t const fields = status_field::state | status_field::flags
+		| status_field::queue_position;
+	auto next_deltas = [&] {
+		ses.post_status_deltas(fields);
+		auto const* a = alert_cast<status_delta_alert>(
+			wait_for_alert(ses, status_delta_alert::alert_type, "ses"));
+		TEST_CHECK(a);
+		return a ? a->deltas : std::vector<torrent_status_delta>{};
+	};
+
+	// the first time a torrent is reported, all requested fields are included
+	auto d = next_deltas();
+	TEST_EQUAL(d.size(), 1);
+	if (d.size() != 1) return;
+	TEST_EQUAL(d[0].info_hashes, atp.info_hashes);
+	TEST_CHECK(d[0].changed == fields);
+	TEST_CHECK(d[0].flags & torrent_flags::paused);
+	TEST_EQUAL(d[0].state, torrent_status::downloading_metadata);
+
+	// nothing changed
+	TEST_CHECK(next_deltas().empty());
+
+	// only the flags changed
+	h.set_flags(torrent_flags::sequential_download);
+	d = next_deltas();
+	TEST_EQUAL(d.size(), 1);
+	if (d.size() != 1) return;
+	TEST_CHECK(d[0].changed == status_field::flags);
+	TEST_CHECK(d[0].flags & torrent_flags::sequential_download);
+	TEST_CHECK(d[0].flags & torrent_flags::paused);
+}
+
 TORRENT_TEST(load_empty_file)
 {
 	settings_pack p = settings();
@@ -249,6 +294,85 @@ TORRENT_TEST(session_stats)
 		, lt::counters::utp_fast_retransmit);
 }
 
+TORRENT_TEST(session_stats_histogram)
+{
+	std::vector<stats_metric> const stats = session_stats_metrics();
+	for (auto const& m : stats)
+	{
+		bool const hist = m.value_index >= lt::counters::disk_job_queue_time_hist
+			&& m.value_index < lt::counters::num_stats_counters;
+		TEST_EQUAL(m.type == metric_type_t::histogram, hist);
+	}
+
+	TEST_EQUAL(lt::find_metric_idx("disk.disk_job_queue_time_hist_0")
+		, lt::counters::disk_job_queue_time_hist);
+	TEST_EQUAL(lt::find_metric_idx("peer.block_request_rtt_hist_11")
+		, lt::counters::block_request_rtt_hist + 11);
+	TEST_EQUAL(lt::find_metric_idx("picker.piece_download_time_hist_31")
+		, lt::counters::piece_download_time_hist + 31);
+
+	lt::counters c;
+	int const h = lt::counters::disk_job_exec_time_hist;
+	c.add_histogram_sample(h, 0);
+	c.add_histogram_sample(h, -10);
+	c.add_histogram_sample(h, 1);
+	c.add_histogram_sample(h, 2);
+	c.add_histogram_sample(h, 3);
+	c.add_histogram_sample(h, 1023);
+	c.add_histogram_sample(h, 1024);
+	c.add_histogram_sample(h, std::int64_t(1) << 40);
+
+	TEST_EQUAL(c[h + 0], 2);
+	TEST_EQUAL(c[h + 1], 1);
+	TEST_EQUAL(c[h + 2], 2);
+	TEST_EQUAL(c[h + 10], 1);
+	TEST_EQUAL(c[h + 11], 1);
+	TEST_EQUAL(c[h + 31], 1);
+
+	std::int64_t total = 0;
+	for (int i = 0; i < lt::counters::num_histogram_buckets; ++i)
+		total += c[h + i];
+	TEST_EQUAL(total, 8);
+
+	// the neighbouring histograms are not affected
+	TEST_EQUAL(c[lt::counters::disk_job_queue_time_hist + 31], 0);
+	TEST_EQUAL(c[lt::counters::block_request_rtt_hist], 0);
+}
+
+TORRENT_TEST(session_stats_threads)
+{
+	// counters are incremented in per-thread shards, and summed when read
+	auto c = std::make_unique<lt::counters>();
+	int const counter = lt::counters::num_incoming_piece;
+	int const gauge = lt::counters::num_peers_connected;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 12; ++t)
+	{
+		threads.emplace_back([&c] {
+			for (int i = 0; i < 1000; ++i)
+			{
+				c->inc_stats_counter(counter);
+				c->inc_stats_counter(gauge, 2);
+			}
+		});
+	}
+	for (auto& t : threads) t.join();
+
+	TEST_EQUAL((*c)[counter], 12000);
+	TEST_EQUAL((*c)[gauge], 24000);
+
+	// copies hold the sum of the shards
+	lt::counters const copy = *c;
+	TEST_EQUAL(copy[counter], 12000);
+	TEST_EQUAL(copy[gauge], 24000);
+
+	c->set_value(counter, 20000);
+	TEST_EQUAL((*c)[counter], 20000);
+	c->inc_stats_counter(counter, 5);
+	TEST_EQUAL((*c)[counter], 20005);
+	TEST_EQUAL(copy[counter], 12000);
+}
+
 TORRENT_TEST(paused_session)
 {
 	lt::session s(settings());
@@ -0,0 +1,110 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+#include "test.hpp"
+#include "libtorrent/aux_/timer_wheel.hpp"
+
+#include <vector>
+
+using namespace lt;
+
+namespace {
+
+std::vector<int> advance(aux::timer_wheel<int>& w, std::int64_t const now)
+{
+	std::vector<int> ret;
+	w.advance(now, [&](int v) { ret.push_back(v); });
+	return ret;
+}
+
+} // anonymous namespace
+
+TORRENT_TEST(timer_wheel_empty)
+{
+	aux::timer_wheel<int> w;
+	TEST_CHECK(w.empty());
+	TEST_CHECK(advance(w, 1000).empty());
+	TEST_EQUAL(w.now(), 1000);
+}
+
+TORRENT_TEST(timer_wheel_expire_in_order)
+{
+	aux::timer_wheel<int> w(10);
+	w.schedule(3, 13);
+	w.schedule(1, 11);
+	w.schedule(2, 12);
+	TEST_EQUAL(w.size(), 3);
+
+	TEST_CHECK(advance(w, 10).empty());
+	TEST_CHECK((advance(w, 11) == std::vector<int>{1}));
+	TEST_CHECK((advance(w, 13) == std::vector<int>{2, 3}));
+	TEST_CHECK(w.empty());
+}
+
+TORRENT_TEST(timer_wheel_past_tick)
+{
+	aux::timer_wheel<int> w(100);
+	// timers scheduled in the past, or at the current tick, fire on the
+	// next advance
+	w.schedule(1, 50);
+	w.schedule(2, 100);
+	TEST_CHECK(advance(w, 100).empty());
+	TEST_CHECK((advance(w, 101) == std::vector<int>{1, 2}));
+}
+
+TORRENT_TEST(timer_wheel_cascade)
+{
+	// exercise every level, and the boundaries between them
+	std::vector<std::int64_t> const ticks = {1, 63, 64, 65, 127, 128, 4095
+		, 4096, 4097, 262143, 262144, 262145, 16777215, 16777216, 50000000};
+
+	aux::timer_wheel<int> w(0);
+	for (int i = 0; i < int(ticks.size()); ++i)
+		w.schedule(i, ticks[std::size_t(i)]);
+
+	for (int i = 0; i < int(ticks.size()); ++i)
+	{
+		std::int64_t const t = ticks[std::size_t(i)];
+		TEST_CHECK(advance(w, t - 1).empty());
+		auto const fired = advance(w, t);
+		TEST_EQUAL(int(fired.size()), 1);
+		if (fired.size() == 1) TEST_EQUAL(fired[0], i);
+		TEST_EQUAL(w.size(), int(ticks.size()) - i - 1);
+	}
+	TEST_CHECK(w.empty());
+}
+
+TORRENT_TEST(timer_wheel_unaligned_start)
+{
+	// starting at a tick that isn't aligned to a slot boundary
+	aux::timer_wheel<int> w(4000);
+	w.schedule(1, 4000 + 100);
+	w.schedule(2, 4000 + 5000);
+	w.schedule(3, 4000 + 300000);
+	TEST_CHECK(advance(w, 4099).empty());
+	TEST_CHECK((advance(w, 4100) == std::vector<int>{1}));
+	TEST_CHECK(advance(w, 8999).empty());
+	TEST_CHECK((advance(w, 9000) == std::vector<int>{2}));
+	TEST_CHECK(advance(w, 303999).empty());
+	TEST_CHECK((advance(w, 304000) == std::vector<int>{3}));
+}
+
+TORRENT_TEST(timer_wheel_reschedule_from_callback)
+{
+	aux::timer_wheel<int> w;
+	w.schedule(0, 5);
+	int fired = 0;
+	// every time the timer fires, schedule it again 5 ticks later
+	w.advance(100, [&](int v) {
+		++fired;
+		w.schedule(v + 1, w.now() + 5);
+	});
+	TEST_EQUAL(fired, 20);
+	TEST_EQUAL(w.size(), 1);
+}
@@ -792,6 +792,50 @@ TORRENT_TEST(ban_ip_updates_want_peers)
 #endif
 }
 
+TORRENT_TEST(dormant_torrent)
+{
+	settings_pack sett = settings();
+	// keep the torrent queued, and every queued torrent dormant
+	sett.set_int(settings_pack::active_downloads, 0);
+	sett.set_int(settings_pack::active_seeds, 0);
+	sett.set_int(settings_pack::hydrated_queued_limit, 0);
+	// don't let connection attempts make the peers fail
+	sett.set_int(settings_pack::connection_speed, 0);
+	lt::session ses(sett);
+
+	std::vector<lt::create_file_entry> fs;
+	fs.emplace_back("test_torrent_dormant", 0x4000 * 4);
+	add_torrent_params p = make_torrent(std::move(fs), 0x4000);
+	p.save_path = ".";
+	p.flags |= torrent_flags::paused | torrent_flags::auto_managed;
+	p.peers.push_back(ep("1.2.3.4", 6881));
+	p.peers.push_back(ep("1.2.3.5", 6881));
+	torrent_handle h = ses.add_torrent(std::move(p));
+
+	for (int i = 0; i < 100 && h.status().connect_candidates != 2; ++i)
+		std::this_thread::sleep_for(100ms);
+	TEST_EQUAL(h.status().connect_candidates, 2);
+
+	// once the auto-manager runs, the peer list is released
+	for (int i = 0; i < 100 && h.status().connect_candidates != 0; ++i)
+		std::this_thread::sleep_for(100ms);
+	TEST_EQUAL(h.status().connect_candidates, 0);
+
+	// the peers are still saved in the resume data
+	h.save_resume_data();
+	alert const* a = wait_for_alert(ses, save_resume_data_alert::alert_type);
+	save_resume_data_alert const* ra = alert_cast<save_resume_data_alert>(a);
+	TEST_CHECK(ra);
+	if (ra) TEST_EQUAL(ra->params.peers.size(), 2);
+
+	// and restored once the torrent is started
+	h.unset_flags(torrent_flags::auto_managed);
+	h.resume();
+	for (int i = 0; i < 100 && h.status().connect_candidates != 2; ++i)
+		std::this_thread::sleep_for(100ms);
+	TEST_EQUAL(h.status().connect_candidates, 2);
+}
+
 namespace {
 int const piece_size = 0x4000 * 128;
 
@@ -222,5 +222,23 @@ TORRENT_TEST(torrent_list_obfuscated_lookup)
 	// this should not exist as an obfuscated hash
 	TEST_CHECK(l.find_obfuscated(sha1_1) == nullptr);
 }
+
+TORRENT_TEST(torrent_list_obfuscated_lookup_version)
+{
+	aux::torrent_list<int> l;
+	l.insert(hybrid, std::make_shared<int>(1337));
+
+	protocol_version v = protocol_version::NUM;
+	TEST_EQUAL(*l.find_obfuscated(aux::torrent_list<int>::obfuscated_hash(sha1_1), &v), 1337);
+	TEST_CHECK(v == protocol_version::V1);
+
+	v = protocol_version::NUM;
+	TEST_EQUAL(*l.find_obfuscated(aux::torrent_list<int>::obfuscated_hash(sha2_1_truncated), &v), 1337);
+	TEST_CHECK(v == protocol_version::V2);
+
+	l.erase(hybrid);
+	TEST_CHECK(l.find_obfuscated(aux::torrent_list<int>::obfuscated_hash(sha1_1)) == nullptr);
+	TEST_CHECK(l.find_obfuscated(aux::torrent_list<int>::obfuscated_hash(sha2_1_truncated)) == nullptr);
+}
 #endif
 
@@ -31,13 +31,21 @@ see LICENSE file.
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "libtorrent/aux_/bandwidth_limit.hpp"
+#include "libtorrent/aux_/bandwidth_manager.hpp"
+#include "libtorrent/aux_/bandwidth_socket.hpp"
+#include "libtorrent/aux_/choker.hpp"
 #include "libtorrent/aux_/merkle.hpp"
 #include "libtorrent/aux_/pe_crypto.hpp"
+#include "libtorrent/aux_/peer_list.hpp"
 #include "libtorrent/aux_/piece_picker.hpp"
+#include "libtorrent/aux_/torrent_peer_allocator.hpp"
 #include "libtorrent/bitfield.hpp"
 #include "libtorrent/hasher.hpp"
 #include "libtorrent/ip_filter.hpp"
@@ -256,12 +264,14 @@ namespace pp_bench {
 			}
 		}
 
-		// scenario 2: pick_pieces()'s rarest-first scan walks the entire
-		// pickable-piece list (m_pieces), testing each entry against the peer's
-		// bitfield -- it never walks the peer's bitfield directly. A peer that
-		// only has one piece therefore costs the same scan as a peer that has
-		// almost everything, since the loop can't stop until it either satisfies
-		// the block request or exhausts the list.
+		// scenario 2: pick_pieces()'s rarest-first scan walks the pickable-piece
+		// list (m_pieces), testing each entry against the peer's bitfield,
+		// until it has satisfied the block request. For peers that only have a
+		// small fraction of the pieces (at most 1/16th, and no more than 1024),
+		// it instead walks the peer's bitfield, skipping 32 pieces at a time,
+		// and visits the peer's pieces in m_pieces order. The "sparse peer,
+		// N pieces" cases sweep across that cutoff, the last one falling back
+		// to the full scan.
 		{
 			piece_picker p = make_picker();
 			p.inc_refcount_all(nullptr); // a background seed, so every piece is pickable
@@ -280,6 +290,25 @@ namespace pp_bench {
 				pick(p, dense_peer, 4, picked);
 				do_not_optimize(picked);
 			}));
+
+			struct pp_case
+			{
+				char const* name;
+				int bits_set;
+			};
+			pp_case const cases[] = {
+				{"piece picker: pick pieces, sparse peer, 100 pieces", 100},
+				{"piece picker: pick pieces, sparse peer, 1000 pieces", 1000},
+				{"piece picker: pick pieces, sparse peer, 5000 pieces", 5000},
+			};
+			for (auto const& c : cases)
+			{
+				auto const bits = sparse_bits(c.bits_set);
+				results.emplace_back(c.name, analyze([&] {
+					pick(p, bits, 200, picked);
+					do_not_optimize(picked);
+				}));
+			}
 		}
 
 		// scenario 3: peers with every piece are tracked as a single m_seeds
@@ -287,7 +316,9 @@ namespace pp_bench {
 		// fails that literal all-bits-set check and instead pays the full
 		// per-piece bitfield scan from scenario 1 -- so a peer missing a single
 		// piece out of num_pieces is far more expensive to account for than one
-		// that's actually complete.
+		// that's actually complete. With availability sampling
+		// (settings_pack::availability_sample_size), a peer outside the sample
+		// is tracked by a single counter too, whatever pieces it has.
 		{
 			piece_picker p = make_picker();
 			results.emplace_back("piece picker: add/remove seed", analyze([&] {
@@ -301,6 +332,11 @@ namespace pp_bench {
 				p.inc_refcount(near_seed, nullptr);
 				p.dec_refcount(near_seed, nullptr);
 			}));
+
+			results.emplace_back("piece picker: add/remove near-seed, uncounted", analyze([&] {
+				p.inc_uncounted_peer();
+				p.dec_uncounted_peer();
+			}));
 		}
 
 		// scenario 4: when a peer we've counted as a seed (via m_seeds) sends a
@@ -403,6 +439,195 @@ namespace pp_bench {
 
 } // namespace pp_bench
 
+// bitfield kernels, over a bitfield the size of a torrent with 4M pieces.
+// count() is what's used to tell how much of the torrent a peer has, and
+// for_each_set_bit() is how the piece picker applies a peer's BITFIELD
+// message to the piece availability, and how a peer's interest is
+// determined. The latter skips words with no bits set, so its cost depends
+// on how many pieces the peer has.
+namespace bf_bench {
+
+	using lt::piece_index_t;
+	using lt::typed_bitfield;
+	using lt::aux::piece_picker;
+
+	constexpr int num_pieces = 4 * 1024 * 1024;
+
+	// every `stride`th bit set
+	typed_bitfield<piece_index_t> strided_bits(int const stride)
+	{
+		typed_bitfield<piece_index_t> bm(num_pieces, false);
+		for (int i = 0; i < num_pieces; i += stride)
+			bm.set_bit(piece_index_t(i));
+		return bm;
+	}
+
+	void run(std::vector<std::pair<char const*, stats>>& results)
+	{
+		typed_bitfield<piece_index_t> const half = strided_bits(2);
+		typed_bitfield<piece_index_t> const sparse = strided_bits(1000);
+
+		results.emplace_back("bitfield: count, 4M bits", analyze([&] {
+			int const ret = half.count();
+			do_not_optimize(ret);
+		}));
+
+		results.emplace_back("bitfield: for each set bit, 4M bits, 0.1% set", analyze([&] {
+			int sum = 0;
+			sparse.for_each_set_bit([&](piece_index_t const i) {
+				sum += static_cast<int>(i);
+				return false;
+			});
+			do_not_optimize(sum);
+		}));
+
+		// the picker is already dirty after the first inc_refcount() that
+		// doesn't fit the incremental path, so this measures the bulk
+		// per-piece counter update
+		piece_picker p(std::int64_t(num_pieces) * 0x4000, 0x4000);
+		results.emplace_back("piece picker: refcount bitfield, 4M pieces, half set", analyze([&] {
+			p.inc_refcount(half, nullptr);
+			p.dec_refcount(half, nullptr);
+		}));
+	}
+
+} // namespace bf_bench
+
+// picking the next peer to connect to, from a peer list with 100k peers where
+// only 1% of them are connect candidates. The rest have failed too many
+// times, which is what a large, long-running swarm mostly looks like.
+namespace pl_bench {
+
+	using lt::aux::peer_list;
+	using lt::aux::torrent_peer;
+	using lt::aux::torrent_peer_allocator;
+	using lt::aux::torrent_state;
+
+	constexpr int num_peers = 100000;
+
+	void run(std::vector<std::pair<char const*, stats>>& results)
+	{
+		torrent_peer_allocator allocator;
+		peer_list pl(allocator);
+
+		torrent_state st;
+		st.max_peerlist_size = 0;
+
+		std::vector<torrent_peer*> peers;
+		peers.reserve(num_peers);
+		std::uint32_t addr = 0x0a000000;
+		for (int i = 0; i < num_peers; ++i)
+		{
+			// spread the addresses out, so they're not inserted in order
+			addr += 0x9e3779b1;
+			lt::tcp::endpoint const ep(lt::address_v4(addr), 6881);
+			torrent_peer* p = pl.add_peer(ep, {}, {}, &st);
+			if (p == nullptr) continue;
+			peers.push_back(p);
+			if (i % 100 != 0) pl.set_failcount(p, st.max_failcount);
+		}
+
+		// every peer we pick is marked as failed, and some other, random,
+		// peer is given another chance, to keep the number of candidates
+		// steady
+		std::uint32_t rnd = 1;
+		results.emplace_back("peer list: connect one peer, 100k peers", analyze([&] {
+			torrent_peer* p = pl.connect_one_peer(0, &st);
+			do_not_optimize(p);
+			if (p == nullptr) return;
+			pl.set_failcount(p, st.max_failcount);
+			rnd = rnd * 1664525 + 1013904223;
+			pl.set_failcount(peers[rnd % peers.size()], 0);
+		}));
+	}
+
+} // namespace pl_bench
+
+// ranking the peers eligible for unchoke, to pick the ones to unchoke. The
+// keys are gathered from the peers once per round, this is the cost of
+// selecting the top unchoke slots among them
+namespace choker_bench {
+
+	using lt::aux::unchoke_candidate;
+
+	std::vector<unchoke_candidate> make_candidates(int const num)
+	{
+		std::vector<unchoke_candidate> ret(static_cast<std::size_t>(num));
+		std::uint32_t rnd = 1;
+		for (auto& c : ret)
+		{
+			rnd = rnd * 1664525 + 1013904223;
+			c.priority = 1;
+			// most peers haven't sent us anything
+			c.downloaded = (rnd >> 24) < 16 ? (rnd & 0xfffff) : 0;
+			c.score = rnd >> 12;
+			c.last_unchoke = lt::time_point(lt::seconds(rnd & 0xffff));
+		}
+		return ret;
+	}
+
+	void run(std::vector<std::pair<char const*, stats>>& results)
+	{
+		struct test_case { char const* name; int num_peers; };
+		test_case const cases[] = {
+			{"choker: select unchoke slots, 10k peers", 10000},
+			{"choker: select unchoke slots, 100k peers", 100000},
+			{"choker: select unchoke slots, 1M peers", 1000000},
+		};
+
+		for (auto const& c : cases)
+		{
+			std::vector<unchoke_candidate> const candidates = make_candidates(c.num_peers);
+			std::vector<unchoke_candidate> work;
+			results.emplace_back(c.name, analyze([&] {
+				work = candidates;
+				lt::aux::select_unchoke_candidates(work, 8);
+				do_not_optimize(work.front().peer);
+			}));
+		}
+	}
+
+} // namespace choker_bench
+
+// a rate limited peer class with 100k connections all waiting for quota.
+// Every round, each connection requests bandwidth, which is queued, and one
+// tick hands out enough quota to satisfy all of them
+namespace bw_bench {
+
+	using lt::aux::bandwidth_channel;
+	using lt::aux::bandwidth_manager;
+
+	constexpr int num_sockets = 100000;
+	constexpr int block_size = 1000;
+
+	struct socket : lt::aux::bandwidth_socket
+	{
+		void assign_bandwidth(int, int const amount) override { quota += amount; }
+		bool is_disconnecting() const override { return false; }
+		std::int64_t quota = 0;
+	};
+
+	void run(std::vector<std::pair<char const*, stats>>& results)
+	{
+		std::vector<std::shared_ptr<socket>> sockets;
+		for (int i = 0; i < num_sockets; ++i)
+			sockets.push_back(std::make_shared<socket>());
+
+		bandwidth_channel channel;
+		channel.throttle(num_sockets * block_size);
+		bandwidth_channel* channels[] = {&channel};
+
+		bandwidth_manager manager(0);
+		results.emplace_back("bandwidth manager: queue and assign, 100k sockets", analyze([&] {
+			for (auto const& s : sockets)
+				manager.request_bandwidth(s, block_size, 1, channels);
+			manager.update_quotas(lt::seconds(1));
+			do_not_optimize(manager.queue_size());
+		}));
+	}
+
+} // namespace bw_bench
+
 // ip_filter benchmark. access() resolves an address against a std::set of
 // non-overlapping ranges (O(log n) in the number of ranges), so its cost
 // depends on how many rules the filter holds rather than on where the
@@ -544,6 +769,46 @@ namespace merkle_bench {
 
 } // namespace merkle_bench
 
+// the cost of incrementing performance counters while the network, disk and
+// hashing threads all do so at the same time. Counters are sharded per
+// thread, gauges are a single shared atomic each, the gauge case shows the
+// cost of contending on the same cache line.
+namespace counters_bench {
+
+	using lt::counters;
+
+	constexpr int num_threads = 4;
+	constexpr int num_increments = 100000;
+
+	void increment(counters& cnt, int const c)
+	{
+		std::vector<std::thread> threads;
+		for (int t = 0; t < num_threads; ++t)
+		{
+			threads.emplace_back([&cnt, c] {
+				for (int i = 0; i < num_increments; ++i)
+					cnt.inc_stats_counter(c);
+			});
+		}
+		for (auto& t : threads) t.join();
+	}
+
+	void run(std::vector<std::pair<char const*, stats>>& results)
+	{
+		auto cnt = std::make_unique<counters>();
+		results.emplace_back("counters: 4 threads x 100k counter increments", analyze([&] {
+			increment(*cnt, counters::num_incoming_piece);
+			do_not_optimize((*cnt)[counters::num_incoming_piece]);
+		}));
+
+		results.emplace_back("counters: 4 threads x 100k gauge increments", analyze([&] {
+			increment(*cnt, counters::num_peers_connected);
+			do_not_optimize((*cnt)[counters::num_peers_connected]);
+		}));
+	}
+
+} // namespace counters_bench
+
 int main()
 try
 {
@@ -604,8 +869,13 @@ try
 	}
 
 	pp_bench::run(results);
+	bf_bench::run(results);
+	pl_bench::run(results);
+	choker_bench::run(results);
+	bw_bench::run(results);
 	ipf_bench::run(results);
 	merkle_bench::run(results);
+	counters_bench::run(results);
 
 	print_bmf(results);
 }
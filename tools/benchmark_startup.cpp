@@ -0,0 +1,195 @@
+/*
+
+Copyright (c) 2026, Arvid Norberg
+All rights reserved.
+
+You may use, distribute and modify this code under the terms of the BSD license,
+see LICENSE file.
+*/
+
+// benchmark_startup - time how long it takes a session to take on a large
+// number of torrents, as when restoring a session at startup.
+//
+// <num-torrents> synthetic torrents are generated up-front (untimed), each
+// with a single file that doesn't exist on disk. They are then added queued
+// (paused and auto-managed), either one async_add_torrent() call at a time
+// or in a single async_add_torrents() batch, and two times are reported:
+// until every add_torrent_alert has been posted, and until every torrent
+// has checked its resume data (torrent_checked_alert).
+
+#include <cinttypes>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "libtorrent/session.hpp"
+#include "libtorrent/session_params.hpp"
+#include "libtorrent/settings_pack.hpp"
+#include "libtorrent/add_torrent_params.hpp"
+#include "libtorrent/create_torrent.hpp"
+#include "libtorrent/load_torrent.hpp"
+#include "libtorrent/alert_types.hpp"
+#include "libtorrent/hasher.hpp"
+#include "libtorrent/bencode.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+	[[noreturn]] void print_usage()
+	{
+		std::cerr << R"(usage: benchmark_startup <num-torrents> [single|batch]
+
+Times adding <num-torrents> queued torrents to a session. "single" adds
+them with one async_add_torrent() call each, "batch" (the default) with a
+single call to async_add_torrents().
+
+Output:
+    added: <ms> ms
+    checked: <ms> ms
+    max rss: <bytes> bytes      (POSIX only)
+)";
+		std::exit(1);
+	}
+
+	lt::add_torrent_params make_torrent(int const i)
+	{
+		int const piece_size = 64 * 1024;
+		int const num_pieces = 256;
+
+		std::vector<lt::create_file_entry> files;
+		files.emplace_back("startup-bench-" + std::to_string(i)
+			, std::int64_t(piece_size) * num_pieces);
+		lt::create_torrent ct(std::move(files), piece_size
+			, lt::create_torrent::v1_only);
+
+		// the content is never verified, every piece just needs a hash that
+		// makes the info-hash unique
+		lt::sha1_hash const h = lt::hasher(reinterpret_cast<char const*>(&i)
+			, sizeof(i)).final();
+		for (lt::piece_index_t p : ct.piece_range())
+			ct.set_hash(p, h);
+
+		lt::add_torrent_params atp = lt::load_torrent_buffer(
+			lt::bencode(ct.generate()));
+		atp.save_path = "./startup_bench";
+		atp.flags |= lt::torrent_flags::paused | lt::torrent_flags::auto_managed;
+		return atp;
+	}
+
+	double ms_since(std::chrono::steady_clock::time_point const start)
+	{
+		return std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+	}
+
+} // namespace
+
+int main(int argc, char const* argv[])
+try
+{
+	if (argc < 2 || argc > 3) print_usage();
+
+	int const num_torrents = std::atoi(argv[1]);
+	if (num_torrents < 1)
+	{
+		std::cerr << "ERROR: <num-torrents> must be >= 1\n";
+		return 1;
+	}
+	bool batch = true;
+	if (argc == 3)
+	{
+		if (std::strcmp(argv[2], "single") == 0) batch = false;
+		else if (std::strcmp(argv[2], "batch") != 0) print_usage();
+	}
+
+	std::vector<lt::add_torrent_params> torrents;
+	torrents.reserve(std::size_t(num_torrents));
+	for (int i = 0; i < num_torrents; ++i)
+		torrents.push_back(make_torrent(i));
+
+	lt::settings_pack pack;
+	pack.set_int(lt::settings_pack::alert_mask, lt::alert_category::status
+		| lt::alert_category::error);
+	pack.set_int(lt::settings_pack::alert_queue_size, num_torrents * 2);
+	pack.set_str(lt::settings_pack::listen_interfaces, "127.0.0.1:0");
+	pack.set_bool(lt::settings_pack::enable_dht, false);
+	pack.set_bool(lt::settings_pack::enable_lsd, false);
+	pack.set_bool(lt::settings_pack::enable_upnp, false);
+	pack.set_bool(lt::settings_pack::enable_natpmp, false);
+	lt::session ses(lt::session_params(std::move(pack)));
+
+	auto const start = std::chrono::steady_clock::now();
+
+	if (batch)
+	{
+		ses.async_add_torrents(std::move(torrents));
+	}
+	else
+	{
+		for (auto& atp : torrents)
+			ses.async_add_torrent(std::move(atp));
+	}
+
+	int added = 0;
+	int checked = 0;
+	double added_ms = 0;
+	std::vector<lt::alert*> alerts;
+	while (checked < num_torrents)
+	{
+		if (!ses.wait_for_alert(lt::seconds(60)))
+		{
+			std::cerr << "ERROR: timed out with " << added << " added and "
+				<< checked << " checked torrents\n";
+			return 1;
+		}
+		ses.pop_alerts(&alerts);
+		for (lt::alert const* a : alerts)
+		{
+			if (auto const* at = lt::alert_cast<lt::add_torrent_alert>(a))
+			{
+				if (at->error)
+				{
+					std::cerr << "ERROR: " << at->message() << "\n";
+					return 1;
+				}
+				if (++added == num_torrents) added_ms = ms_since(start);
+			}
+			else if (lt::alert_cast<lt::torrent_checked_alert>(a))
+			{
+				++checked;
+			}
+		}
+	}
+	double const checked_ms = ms_since(start);
+
+	std::printf("added: %.3f ms\n", added_ms);
+	std::printf("checked: %.3f ms\n", checked_ms);
+
+#ifndef _WIN32
+	// ru_maxrss is in KiB on Linux but in bytes on macOS
+	struct rusage ru = {};
+	if (getrusage(RUSAGE_SELF, &ru) == 0)
+	{
+#ifdef __APPLE__
+		std::int64_t const max_rss_bytes = std::int64_t(ru.ru_maxrss);
+#else
+		std::int64_t const max_rss_bytes = std::int64_t(ru.ru_maxrss) * 1024;
+#endif
+		std::printf("max rss: %" PRId64 " bytes\n", max_rss_bytes);
+	}
+#endif
+
+	return 0;
+}
+catch (std::exception const& e)
+{
+	std::cerr << "ERROR: " << e.what() << "\n";
+	return 1;
+}
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Summarize the slowest handlers in a handler trace.
+
+Reads a Chrome trace-event JSON file, as returned by
+``lt::handler_trace_json()`` in a libtorrent build with ``handler-trace=on``,
+and prints, for every handler name, the number of calls and the total, mean,
+99th percentile and maximum duration, ordered by the maximum duration. It's
+followed by the slowest individual calls, which are the stalls of the network
+thread.
+
+Nested events (e.g. ``session_impl::on_tick`` running inside
+``tick_handler``) are each reported on their own, so a slow outer event can be
+attributed to the inner ones overlapping it.
+"""
+
+import argparse
+from collections import defaultdict
+import json
+from pathlib import Path
+from typing import Any
+
+
+def load(path: Path) -> list[dict[str, Any]]:
+    """Return the complete ("X") events in the trace file."""
+    with open(path) as f:
+        trace = json.load(f)
+    # both the object and the bare array form of the format are accepted
+    events = trace["traceEvents"] if isinstance(trace, dict) else trace
+    return [e for e in events if e.get("ph") == "X"]
+
+
+def percentile(durations: list[float], pct: float) -> float:
+    """``durations`` must be sorted."""
+    idx = min(len(durations) - 1, int(len(durations) * pct / 100))
+    return durations[idx]
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("trace", type=Path, help="the trace JSON file")
+    parser.add_argument(
+        "-n",
+        "--num",
+        type=int,
+        default=20,
+        help="the number of slowest individual calls to print (default: 20)",
+    )
+    args = parser.parse_args()
+
+    events = load(args.trace)
+    if not events:
+        print("no events in trace")
+        return
+
+    by_name: dict[str, list[float]] = defaultdict(list)
+    for e in events:
+        by_name[e["name"]].append(float(e["dur"]))
+
+    rows = []
+    for name, durations in by_name.items():
+        durations.sort()
+        rows.append(
+            (
+                name,
+                len(durations),
+                sum(durations),
+                percentile(durations, 99),
+                durations[-1],
+            )
+        )
+    rows.sort(key=lambda r: r[4], reverse=True)
+
+    name_width = max(len("handler"), max(len(r[0]) for r in rows))
+    print(
+        f"{'handler':<{name_width}} {'calls':>9} {'total ms':>11} "
+        f"{'mean us':>10} {'p99 us':>10} {'max us':>10}"
+    )
+    for name, calls, total, p99, longest in rows:
+        print(
+            f"{name:<{name_width}} {calls:>9} {total / 1000:>11.1f} "
+            f"{total / calls:>10.1f} {p99:>10.1f} {longest:>10.1f}"
+        )
+
+    start = min(float(e["ts"]) for e in events)
+    print(f"\nslowest {args.num} calls (time relative to the first event):")
+    print(f"{'ms':>12} {'tid':>5} {'duration us':>12}  handler")
+    slowest = sorted(events, key=lambda e: float(e["dur"]), reverse=True)
+    for e in slowest[: args.num]:
+        print(
+            f"{(float(e['ts']) - start) / 1000:>12.3f} {e.get('tid', 0):>5} "
+            f"{float(e['dur']):>12.1f}  {e['name']}"
+        )
+
+
+if __name__ == "__main__":
+    main()